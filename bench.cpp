@@ -0,0 +1,575 @@
+#include "set.h"
+#include "node_pool.h"
+#include "concurrent_set.h"
+#include "set_io.h"
+#include "string_set.h"
+#include "indexed_set.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <string_view>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+/**
+	@file bench.cpp
+	@brief Benchmark delle politiche di memorizzazione, degli allocatori, del set concorrente e della scrittura su file
+**/
+
+/**
+	@brief Definizione del funtore per l'uguaglianza tra interi
+
+	Funtore che definisce il criterio con cui vengono comparate
+	due variabili di tipo intero per valutarne l'uguaglianza.
+**/
+struct equal_int{
+
+	bool operator()(const int a, const int b) const {
+		return a == b;
+	}
+};
+
+/**
+	@brief Definizione del funtore per il controllo della disparità
+
+	Funtore che definisce il criterio con cui vengono comparate
+	due variabili di tipo intero per valutarne la disparità.
+**/
+struct is_odd{
+
+	bool operator()(const int a) const {
+		return (a%2) != 0;
+	}
+};
+
+/**
+	@brief Definizione della struttura dati "voce"
+
+	Voce di una rubrica telefonica, come in main.cpp.
+**/
+struct voce{
+	std::string nome;
+	std::string cognome;
+	std::string ntel;
+};
+
+/**
+	@brief Uguaglianza e hash delle voci per numero di telefono
+**/
+struct equal_voce_ntel{
+	bool operator()(const voce &a, const voce &b) const {
+		return a.ntel == b.ntel;
+	}
+};
+
+struct hash_voce_ntel{
+	std::size_t operator()(const voce &v) const {
+		return std::hash<std::string>()(v.ntel);
+	}
+};
+
+/**
+	@brief Predicato che esclude le voci con un dato cognome
+**/
+struct other_surname{
+	const std::string *cognome;
+
+	bool operator()(const voce &v) const {
+		return v.cognome != *cognome;
+	}
+};
+
+typedef std::chrono::steady_clock bench_clock;
+
+/**
+	@brief Nanosecondi trascorsi da un istante
+
+	@param start Istante iniziale.
+	@return I nanosecondi trascorsi da start.
+**/
+double elapsed_ns(bench_clock::time_point start){
+	return std::chrono::duration<double, std::nano>(bench_clock::now() - start).count();
+}
+
+/**
+	@brief Misura l'iterazione e filter_out su un set di n interi
+
+	Il set viene riempito con n interi, poi viene iterato ripetutamente
+	fino a visitare almeno 50M elementi. Stampa i nanosecondi per elemento.
+	@param name Nome della politica di memorizzazione.
+	@param n Numero di elementi.
+**/
+template <typename Storage>
+void bench_iteration(const char *name, unsigned int n){
+
+	typedef set<int, equal_int, std::hash<int>, Storage> set_type;
+	set_type s;
+
+	for(unsigned int k = 0; k < n; ++k)
+		s.add(static_cast<int>(k));
+
+	unsigned int rounds = 50000000 / n + 1;
+	long long sum = 0;
+
+	bench_clock::time_point start = bench_clock::now();
+	for(unsigned int r = 0; r < rounds; ++r)
+		for(typename set_type::const_iterator i = s.begin(), ie = s.end(); i != ie; ++i)
+			sum += *i;
+	double iter_ns = elapsed_ns(start) / (double(rounds) * n);
+
+	start = bench_clock::now();
+	set_type filtered = filter_out(s, is_odd());
+	double filter_ns = elapsed_ns(start) / n;
+
+	std::cout << std::setw(16) << name << std::setw(12) << n
+		<< std::setw(14) << std::fixed << std::setprecision(3) << iter_ns
+		<< std::setw(14) << filter_ns
+		<< "   (" << sum % 7 + filtered.size() % 7 << ")" << std::endl;
+}
+
+/**
+	@brief Misura costruzione e distruzione di un set di n interi
+
+	Stampa i nanosecondi per elemento impiegati da add e da clear_set
+	usando la lista con l'allocatore Alloc.
+	@param name Nome dell'allocatore.
+	@param n Numero di elementi.
+**/
+template <typename Alloc>
+void bench_allocator(const char *name, unsigned int n){
+
+	typedef set<int, equal_int, std::hash<int>, list_storage, Alloc> set_type;
+	set_type s;
+
+	bench_clock::time_point start = bench_clock::now();
+	for(unsigned int k = 0; k < n; ++k)
+		s.add(static_cast<int>(k));
+	double build_ns = elapsed_ns(start) / n;
+
+	start = bench_clock::now();
+	s.clear_set();
+	double clear_ns = elapsed_ns(start) / n;
+
+	std::cout << std::setw(22) << name << std::setw(12) << n
+		<< std::setw(14) << std::fixed << std::setprecision(3) << build_ns
+		<< std::setw(14) << clear_ns << std::endl;
+}
+
+/**
+	@brief Set protetto da un unico mutex
+
+	Riferimento per il confronto con concurrent_set: tutte le operazioni
+	di tutti i thread vengono serializzate.
+**/
+struct locked_set{
+	std::mutex lock;
+	std::unordered_set<int> data;
+
+	bool contains(int v){
+		std::lock_guard<std::mutex> guard(lock);
+		return data.count(v) != 0;
+	}
+
+	bool try_add(int v){
+		std::lock_guard<std::mutex> guard(lock);
+		return data.insert(v).second;
+	}
+
+	bool try_remove(int v){
+		std::lock_guard<std::mutex> guard(lock);
+		return data.erase(v) != 0;
+	}
+};
+
+/**
+	@brief Misura il throughput di un set condiviso tra più thread
+
+	Il set viene riempito con keys/2 interi, poi ogni thread esegue ops operazioni
+	su chiavi casuali in [0, keys): 90% ricerche, 5% inserimenti, 5% rimozioni.
+	Stampa i milioni di operazioni al secondo complessivi.
+	@param name Nome del set.
+	@param threads Numero di thread.
+	@param ops Numero di operazioni per thread.
+**/
+template <typename Set>
+void bench_concurrent(const char *name, unsigned int threads, unsigned int ops){
+
+	const unsigned int keys = 200000;
+	Set s;
+	for(unsigned int k = 0; k < keys; k += 2)
+		s.try_add(static_cast<int>(k));
+
+	std::vector<std::thread> workers;
+	std::vector<unsigned int> hits(threads);
+
+	bench_clock::time_point start = bench_clock::now();
+	for(unsigned int t = 0; t < threads; ++t)
+		workers.push_back(std::thread([&s, &hits, t, ops, keys](){
+			std::uint64_t x = 88172645463325252ull + t;
+			unsigned int found = 0;
+			for(unsigned int k = 0; k < ops; ++k){
+				x ^= x << 13;
+				x ^= x >> 7;
+				x ^= x << 17;
+				int v = static_cast<int>(x % keys);
+				unsigned int op = static_cast<unsigned int>(x >> 40) % 100;
+				if(op < 90)
+					found += s.contains(v);
+				else if(op < 95)
+					found += s.try_add(v);
+				else
+					found += s.try_remove(v);
+			}
+			hits[t] = found;
+		}));
+	for(unsigned int t = 0; t < threads; ++t)
+		workers[t].join();
+	double mops = double(threads) * ops / elapsed_ns(start) * 1000.0;
+
+	unsigned int found = 0;
+	for(unsigned int t = 0; t < threads; ++t)
+		found += hits[t];
+
+	std::cout << std::setw(22) << name << std::setw(12) << threads
+		<< std::setw(14) << std::fixed << std::setprecision(3) << mops
+		<< "   (" << found % 7 << ")" << std::endl;
+}
+
+/**
+	@brief Misura add e remove su un set piccolo senza indice hash
+
+	Il set viene riempito con n interi e poi svuotato rimuovendoli dal primo:
+	ogni operazione scandisce gli elementi presenti. Stampa i nanosecondi per operazione.
+	@param name Nome della configurazione.
+	@param n Numero di elementi.
+**/
+template <typename Set>
+void bench_scan(const char *name, unsigned int n){
+
+	unsigned int rounds = 20000000 / (n * n) + 1;
+
+	bench_clock::time_point start = bench_clock::now();
+	for(unsigned int r = 0; r < rounds; ++r){
+		Set s;
+		for(unsigned int k = 0; k < n; ++k)
+			s.add(static_cast<int>(k));
+		for(unsigned int k = 0; k < n; ++k)
+			s.remove(static_cast<int>(k));
+	}
+	double op_ns = elapsed_ns(start) / (2.0 * rounds * n);
+
+	std::cout << std::setw(22) << name << std::setw(12) << n
+		<< std::setw(14) << std::fixed << std::setprecision(3) << op_ns << std::endl;
+}
+
+/**
+	@brief Misura la costruzione di molti set piccoli
+
+	Costruisce e distrugge ripetutamente un set di n interi, cercando ogni
+	elemento una volta. Stampa i nanosecondi per set.
+	@param name Nome della configurazione.
+	@param n Numero di elementi di ogni set.
+**/
+template <typename Set>
+void bench_tiny(const char *name, unsigned int n){
+
+	const unsigned int rounds = 1000000;
+	unsigned int found = 0;
+
+	bench_clock::time_point start = bench_clock::now();
+	for(unsigned int r = 0; r < rounds; ++r){
+		Set s;
+		for(unsigned int k = 0; k < n; ++k)
+			s.add(static_cast<int>(k + r));
+		for(unsigned int k = 0; k < n; ++k)
+			found += !s.try_add(static_cast<int>(k + r));
+	}
+	double set_ns = elapsed_ns(start) / rounds;
+
+	std::cout << std::setw(22) << name << std::setw(12) << n
+		<< std::setw(14) << std::fixed << std::setprecision(3) << set_ns
+		<< "   (" << found % 7 << ")" << std::endl;
+}
+
+/**
+	@brief Confronta operator<< e write_to nella scrittura di un set
+
+	Scrive un set di n elementi su /dev/null con operator<< su uno std::ofstream
+	e con write_to su un FILE*. Stampa i nanosecondi per elemento.
+	@param name Nome del tipo degli elementi.
+	@param s Set da scrivere.
+**/
+template <typename Set>
+void bench_output(const char *name, const Set &s){
+
+	std::ofstream os("/dev/null");
+	bench_clock::time_point start = bench_clock::now();
+	os << s;
+	os.flush();
+	double stream_ns = elapsed_ns(start) / s.size();
+
+	std::FILE *file = std::fopen("/dev/null", "w");
+	start = bench_clock::now();
+	write_to(file, s);
+	std::fflush(file);
+	double write_ns = elapsed_ns(start) / s.size();
+	std::fclose(file);
+
+	std::cout << std::setw(22) << name << std::setw(12) << s.size()
+		<< std::setw(14) << std::fixed << std::setprecision(3) << stream_ns
+		<< std::setw(14) << write_ns << std::endl;
+}
+
+/**
+	@brief Misura la memoria per elemento di una politica di memorizzazione
+
+	Aggiunge n elementi al contenitore della politica Storage, senza indice hash,
+	e stampa i byte allocati per elemento, compresa l'intestazione di ogni
+	allocazione (solo con glibc). Con n potenza di 2 gli array sono pieni.
+	@param name Nome della configurazione.
+	@param make Funtore che restituisce il k-esimo elemento.
+	@param n Numero di elementi.
+**/
+template <typename Storage, typename T, typename Make>
+void bench_memory(const char *name, Make make, unsigned int n){
+
+#if defined(__GLIBC__)
+	std::vector<T> values;
+	values.reserve(n);
+	for(unsigned int k = 0; k < n; ++k)
+		values.push_back(make(k));
+
+	struct mallinfo2 info = mallinfo2();
+	std::size_t before = info.uordblks + info.hblkhd;
+	typename Storage::template container<T, std::allocator<T> > c;
+	for(unsigned int k = 0; k < n; ++k)
+		c.emplace_back(values[k]);
+	info = mallinfo2();
+	double bytes = double(info.uordblks + info.hblkhd - before) / n;
+
+	std::cout << std::setw(22) << name << std::setw(12) << n
+		<< std::setw(14) << std::fixed << std::setprecision(1) << bytes << std::endl;
+#else
+	(void)name;
+	(void)make;
+	(void)n;
+#endif
+}
+
+/**
+	@brief Misura un set di n identificatori corti
+
+	Aggiunge n stringhe e poi le cerca tutte a partire da string_view su un
+	buffer, come farebbe un parser; stampa i nanosecondi per elemento di
+	aggiunta e ricerca e i byte allocati per elemento (solo con glibc).
+	@param name Nome del set.
+	@param n Numero di elementi.
+	@param contains Funtore che cerca una string_view nel set.
+**/
+template <typename Set, typename Contains>
+void bench_strings(const char *name, unsigned int n, Contains contains){
+
+	std::string buffer;
+	std::vector<std::size_t> ends;
+	for(unsigned int k = 0; k < n; ++k){
+		buffer += "id_" + std::to_string(k * 2654435761u);
+		ends.push_back(buffer.size());
+	}
+	std::vector<std::string_view> keys;
+	for(unsigned int k = 0; k < n; ++k){
+		std::size_t b = k ? ends[k - 1] : 0;
+		keys.push_back(std::string_view(buffer).substr(b, ends[k] - b));
+	}
+
+#if defined(__GLIBC__)
+	std::size_t before = mallinfo2().uordblks + mallinfo2().hblkhd;
+#endif
+	bench_clock::time_point start = bench_clock::now();
+	Set s;
+	for(unsigned int k = 0; k < n; ++k)
+		s.add(typename Set::const_iterator::value_type(keys[k]));
+	double add_ns = elapsed_ns(start) / n;
+	double bytes = 0;
+#if defined(__GLIBC__)
+	bytes = double(mallinfo2().uordblks + mallinfo2().hblkhd - before) / n;
+#endif
+
+	std::size_t found = 0;
+	start = bench_clock::now();
+	for(unsigned int r = 0; r < 4; ++r)
+		for(unsigned int k = 0; k < n; ++k)
+			found += contains(s, keys[(k * 7919u) % n]);
+	double lookup_ns = elapsed_ns(start) / (4.0 * n);
+
+	std::cout << std::setw(22) << name << std::setw(12) << n
+		<< std::setw(14) << std::fixed << std::setprecision(3) << add_ns
+		<< std::setw(14) << lookup_ns << std::setw(14) << std::setprecision(1) << bytes
+		<< "   (" << found % 7 << ")" << std::endl;
+}
+
+/**
+	@brief Misura la ricerca per cognome su n voci
+
+	Confronta filter_out, che scandisce e copia, con equal_range su un indice
+	secondario di indexed_set. Stampa i nanosecondi per elemento di add (con e
+	senza indice) e i microsecondi per ricerca.
+	@param n Numero di voci, con 5000 cognomi distinti.
+**/
+void bench_secondary(unsigned int n){
+
+	typedef set<voce, equal_voce_ntel, hash_voce_ntel> plain_set;
+	typedef indexed_set<voce, equal_voce_ntel, hash_voce_ntel> surname_set;
+
+	std::vector<voce> values;
+	values.reserve(n);
+	for(unsigned int k = 0; k < n; ++k)
+		values.push_back(voce{"Nome" + std::to_string(k % 1000), "Cognome" + std::to_string(k % 5000), std::to_string(k)});
+
+	bench_clock::time_point start = bench_clock::now();
+	plain_set plain;
+	for(unsigned int k = 0; k < n; ++k)
+		plain.add(values[k]);
+	double plain_add = elapsed_ns(start) / n;
+
+	start = bench_clock::now();
+	surname_set indexed;
+	auto by_surname = indexed.add_index(&voce::cognome);
+	for(unsigned int k = 0; k < n; ++k)
+		indexed.add(values[k]);
+	double indexed_add = elapsed_ns(start) / n;
+
+	const unsigned int queries = 20;
+	std::size_t found = 0;
+	start = bench_clock::now();
+	for(unsigned int q = 0; q < queries; ++q){
+		std::string cognome = "Cognome" + std::to_string(q * 37);
+		other_surname pred = {&cognome};
+		found += filter_out(plain, pred).size();
+	}
+	double scan_us = elapsed_ns(start) / queries / 1000;
+
+	start = bench_clock::now();
+	for(unsigned int q = 0; q < queries; ++q){
+		surname_set::match_range r = indexed.equal_range(by_surname, "Cognome" + std::to_string(q * 37));
+		for(surname_set::match_iterator i = r.first; i != r.second; ++i)
+			found += i->ntel.size() > 0;
+	}
+	double index_us = elapsed_ns(start) / queries / 1000;
+
+	std::cout << std::setw(22) << "filter_out" << std::setw(12) << n
+		<< std::setw(14) << std::fixed << std::setprecision(3) << plain_add
+		<< std::setw(14) << scan_us << std::endl;
+	std::cout << std::setw(22) << "equal_range" << std::setw(12) << n
+		<< std::setw(14) << indexed_add << std::setw(14) << index_us
+		<< "   (" << found % 7 << ")" << std::endl;
+}
+
+int main(void){
+
+	std::cout << std::setw(16) << "storage" << std::setw(12) << "elements"
+		<< std::setw(14) << "iter ns/el" << std::setw(14) << "filter ns/el" << std::endl;
+
+	const unsigned int sizes[] = {1000, 100000, 10000000};
+
+	for(unsigned int i = 0; i < 3; ++i){
+		bench_iteration<list_storage>("list_storage", sizes[i]);
+		bench_iteration<vector_storage>("vector_storage", sizes[i]);
+		bench_iteration<compact_storage>("compact_storage", sizes[i]);
+	}
+
+	std::cout << std::endl << std::setw(22) << "memory" << std::setw(12) << "elements"
+		<< std::setw(14) << "bytes/el" << std::endl;
+
+	auto make_int = [](unsigned int k){ return static_cast<int>(k); };
+	auto make_string = [](unsigned int k){ return "id_" + std::to_string(k); };
+	auto make_voce = [](unsigned int k){
+		return voce{"Nome" + std::to_string(k % 1000), "Cognome" + std::to_string(k % 5000), std::to_string(k)};
+	};
+	const unsigned int memory_size = 1 << 20;
+
+	bench_memory<list_storage, int>("int list", make_int, memory_size);
+	bench_memory<vector_storage, int>("int vector", make_int, memory_size);
+	bench_memory<compact_storage, int>("int compact", make_int, memory_size);
+	bench_memory<list_storage, std::string>("string list", make_string, memory_size);
+	bench_memory<vector_storage, std::string>("string vector", make_string, memory_size);
+	bench_memory<compact_storage, std::string>("string compact", make_string, memory_size);
+	bench_memory<list_storage, voce>("voce list", make_voce, memory_size);
+	bench_memory<vector_storage, voce>("voce vector", make_voce, memory_size);
+	bench_memory<compact_storage, voce>("voce compact", make_voce, memory_size);
+
+	std::cout << std::endl << std::setw(22) << "strings" << std::setw(12) << "elements"
+		<< std::setw(14) << "add ns/el" << std::setw(14) << "find ns/el" << std::setw(14) << "bytes/el" << std::endl;
+
+	typedef set<std::string, std::equal_to<std::string>, std::hash<std::string>, vector_storage> string_vector_set;
+	for(unsigned int i = 1; i < 3; ++i){
+		bench_strings<string_vector_set>("set<std::string>", sizes[i],
+			[](const string_vector_set &s, std::string_view v){ return s.contains(std::string(v)); });
+		bench_strings<string_set>("string_set", sizes[i],
+			[](const string_set &s, std::string_view v){ return s.contains(v); });
+	}
+
+	std::cout << std::endl << std::setw(22) << "by surname" << std::setw(12) << "elements"
+		<< std::setw(14) << "add ns/el" << std::setw(14) << "query us" << std::endl;
+
+	bench_secondary(1000000);
+
+	std::cout << std::endl << std::setw(22) << "allocator" << std::setw(12) << "elements"
+		<< std::setw(14) << "add ns/el" << std::setw(14) << "clear ns/el" << std::endl;
+
+	bench_allocator<std::allocator<int> >("std::allocator", 10000000);
+	bench_allocator<node_pool_allocator<int> >("node_pool_allocator", 10000000);
+
+	std::cout << std::endl << std::setw(22) << "scan" << std::setw(12) << "elements"
+		<< std::setw(14) << "op ns" << std::endl;
+
+	const unsigned int small_sizes[] = {16, 256, 4096};
+
+	for(unsigned int i = 0; i < 3; ++i){
+		bench_scan<set<int, equal_int> >("list + equal_int", small_sizes[i]);
+		bench_scan<set<int, equal_int, no_hash, vector_storage> >("vector + equal_int", small_sizes[i]);
+		bench_scan<set<int> >("vector + simd", small_sizes[i]);
+	}
+
+	std::cout << std::endl << std::setw(22) << "tiny set" << std::setw(12) << "elements"
+		<< std::setw(14) << "ns/set" << std::endl;
+
+	bench_tiny<set<int, equal_int, std::hash<int> > >("list_storage", 6);
+	bench_tiny<set<int, equal_int, std::hash<int>, vector_storage> >("vector_storage", 6);
+	bench_tiny<set<int, equal_int, std::hash<int>, small_storage<8> > >("small_storage<8>", 6);
+
+	std::cout << std::endl << std::setw(22) << "output" << std::setw(12) << "elements"
+		<< std::setw(14) << "<< ns/el" << std::setw(14) << "write ns/el" << std::endl;
+
+	set<int, equal_int, std::hash<int>, vector_storage> ints;
+	set<double, std::equal_to<double>, std::hash<double>, vector_storage> doubles;
+	for(unsigned int k = 0; k < 10000000; ++k){
+		ints.add(static_cast<int>(k * 2654435761u));
+		doubles.add(k * 0.37);
+	}
+	bench_output("int", ints);
+	bench_output("double", doubles);
+
+	std::cout << std::endl << std::setw(22) << "set" << std::setw(12) << "threads"
+		<< std::setw(14) << "Mops/s" << std::endl;
+
+	unsigned int cores = std::thread::hardware_concurrency();
+	if(cores == 0)
+		cores = 1;
+	for(unsigned int t = 1; ; t = (t * 2 < cores) ? t * 2 : cores){
+		bench_concurrent<locked_set>("unordered_set + mutex", t, 2000000);
+		bench_concurrent<concurrent_set<int, equal_int> >("concurrent_set", t, 2000000);
+		if(t == cores)
+			break;
+	}
+	return 0;
+}
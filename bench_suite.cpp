@@ -0,0 +1,390 @@
+#include "set.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <functional>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <new>
+#include <atomic>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+	@file bench_suite.cpp
+	@brief Benchmark di tutte le operazioni del set al variare del tipo e del numero di elementi
+
+	Per ogni tipo di elemento (int, std::string, voce) e ogni dimensione da 10 a 10M
+	misura add, remove, operator[], iterazione, costruttore di copia, operator=,
+	filter_out e operator+, riportando per ciascuna operazione i nanosecondi e le
+	allocazioni per elemento e il picco di memoria residente del processo.
+	Ogni tipo viene misurato con l'indice hash (index = hash) e con la configurazione
+	di default senza funtore di hash (index = linear); quest'ultima ha add e remove
+	con ricerca lineare, quindi viene misurata solo fino a linear_max_size elementi.
+	Ogni combinazione di tipo e dimensione viene eseguita in un processo figlio,
+	così che il picco di memoria non dipenda dalle misure precedenti.
+
+	Uso: bench_suite.exe [csv|json] [dimensione massima]
+	Il formato json produce un oggetto per riga.
+**/
+
+static std::atomic<unsigned long long> allocations(0);	///< Numero di chiamate a operator new
+
+void *operator new(std::size_t size){
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if(void *p = std::malloc(size ? size : 1))
+		return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept{
+	std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept{
+	std::free(p);
+}
+
+/**
+	@brief Definizione del funtore per l'uguaglianza tra interi
+**/
+struct equal_int{
+
+	bool operator()(const int a, const int b) const {
+		return a == b;
+	}
+};
+
+/**
+	@brief Definizione del funtore per l'uguaglianza tra stringhe
+**/
+struct equal_string{
+
+	bool operator()(const std::string &a, const std::string &b) const {
+		return a == b;
+	}
+};
+
+/**
+	@brief Definizione della struttura dati "voce"
+
+	Voce di una rubrica telefonica, come in main.cpp.
+**/
+struct voce{
+	std::string nome;
+	std::string cognome;
+	std::string ntel;
+
+	voce(const std::string &n, const std::string &cg, const std::string &nt)
+	: nome(n), cognome(cg), ntel(nt) {}
+
+	bool operator==(const voce &other) const{
+		return (this->ntel == other.ntel &&
+			this->nome == other.nome &&
+			this->cognome == other.cognome);
+	}
+};
+
+/**
+	@brief Definizione del funtore per l'uguaglianza tra voci
+**/
+struct equal_voce{
+
+	bool operator()(const voce &v1, const voce &v2) const {
+		return v1 == v2;
+	}
+};
+
+/**
+	@brief Definizione del funtore di hash per le voci
+**/
+struct hash_voce{
+
+	std::size_t operator()(const voce &v) const {
+		std::hash<std::string> h;
+		std::size_t seed = h(v.ntel);
+		seed ^= h(v.nome) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+		seed ^= h(v.cognome) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+		return seed;
+	}
+};
+
+/**
+	@brief Generatore degli elementi e predicato per filter_out
+
+	Per ogni tipo: set_type e linear_set_type sono il set con e senza indice hash,
+	make(k) restituisce il k-esimo elemento (distinti per k diversi),
+	keep(v) seleziona circa metà degli elementi.
+**/
+template <typename T>
+struct element_traits;
+
+template <>
+struct element_traits<int>{
+	typedef set<int, equal_int, std::hash<int> > set_type;
+	typedef set<int, equal_int> linear_set_type;
+	static const char *name(void){ return "int"; }
+
+	static int make(unsigned int k){
+		return static_cast<int>(k * 2654435761u);
+	}
+
+	struct keep{
+		bool operator()(int v) const { return (v & 1) == 0; }
+	};
+};
+
+template <>
+struct element_traits<std::string>{
+	typedef set<std::string, equal_string, std::hash<std::string> > set_type;
+	typedef set<std::string, equal_string> linear_set_type;
+	static const char *name(void){ return "string"; }
+
+	static std::string make(unsigned int k){
+		return "id_" + std::to_string(k * 2654435761u);
+	}
+
+	struct keep{
+		bool operator()(const std::string &v) const { return (v.back() & 1) == 0; }
+	};
+};
+
+template <>
+struct element_traits<voce>{
+	typedef set<voce, equal_voce, hash_voce> set_type;
+	typedef set<voce, equal_voce> linear_set_type;
+	static const char *name(void){ return "voce"; }
+
+	static voce make(unsigned int k){
+		return voce("Nome" + std::to_string(k % 1000), "Cognome" + std::to_string(k % 5000),
+			std::to_string(3000000000ull + k));
+	}
+
+	struct keep{
+		bool operator()(const voce &v) const { return (v.ntel.back() & 1) == 0; }
+	};
+};
+
+typedef std::chrono::steady_clock bench_clock;
+
+static const unsigned int linear_max_size = 1000;	///< Dimensione massima misurata senza indice hash
+
+/**
+	@brief Formato dei risultati
+**/
+enum output_format{ csv, json };
+
+/**
+	@brief Misura di un'operazione
+
+	Accumula tempo e allocazioni di più ripetizioni di un'operazione:
+	start() e stop() delimitano ogni ripetizione, report() stampa il risultato.
+**/
+class measure{
+	bench_clock::time_point _start;	///< Inizio della ripetizione corrente
+	unsigned long long _allocations;	///< Allocazioni all'inizio della ripetizione corrente
+	double _ns;	///< Nanosecondi accumulati
+	unsigned long long _allocated;	///< Allocazioni accumulate
+
+public:
+	measure() : _allocations(0), _ns(0), _allocated(0) {}
+
+	void start(void){
+		_allocations = allocations.load(std::memory_order_relaxed);
+		_start = bench_clock::now();
+	}
+
+	void stop(void){
+		_ns += std::chrono::duration<double, std::nano>(bench_clock::now() - _start).count();
+		_allocated += allocations.load(std::memory_order_relaxed) - _allocations;
+	}
+
+	/**
+		@brief Stampa il risultato
+
+		@param format Formato dei risultati.
+		@param type Nome del tipo degli elementi.
+		@param config Nome della configurazione dell'indice (hash o linear).
+		@param op Nome dell'operazione.
+		@param n Numero di elementi del set.
+		@param ops Numero complessivo di operazioni (elementi elaborati) misurate.
+	**/
+	void report(output_format format, const char *type, const char *config, const char *op, unsigned int n, double ops) const{
+
+		struct rusage usage;
+		getrusage(RUSAGE_SELF, &usage);
+
+		if(format == csv)
+			std::printf("%s,%s,%s,%u,%.3f,%.3f,%ld\n", type, config, op, n, _ns / ops, _allocated / ops, usage.ru_maxrss);
+		else
+			std::printf("{\"type\": \"%s\", \"index\": \"%s\", \"op\": \"%s\", \"elements\": %u, \"ns_per_op\": %.3f, "
+				"\"allocs_per_op\": %.3f, \"peak_rss_kb\": %ld}\n",
+				type, config, op, n, _ns / ops, _allocated / ops, usage.ru_maxrss);
+	}
+};
+
+/**
+	@brief Misura tutte le operazioni su set di n elementi di tipo T
+
+	Il tipo del set è element_traits<T>::set_type oppure element_traits<T>::linear_set_type.
+	I set piccoli vengono costruiti più volte, in modo che ogni misura
+	elabori almeno 1M elementi. Le operazioni per elemento sono:
+	add, remove, operator[], iterazione: un elemento per chiamata o passo;
+	copy, operator=, filter_out: gli elementi del set sorgente;
+	operator+: gli elementi dei due operandi, che sono disgiunti.
+	@param format Formato dei risultati.
+	@param config Nome della configurazione dell'indice (hash o linear).
+	@param n Numero di elementi.
+**/
+template <typename T, typename S>
+void bench_type(output_format format, const char *config, unsigned int n){
+
+	typedef element_traits<T> traits;
+	typedef S set_type;
+	const char *type = traits::name();
+	unsigned int rounds = 1000000 / n + 1;
+
+	std::vector<T> values;
+	values.reserve(n);
+	for(unsigned int k = 0; k < n; ++k)
+		values.push_back(traits::make(k));
+
+	measure add;
+	set_type s;
+	for(unsigned int r = 0; r < rounds; ++r){
+		set_type tmp;
+		add.start();
+		for(unsigned int k = 0; k < n; ++k)
+			tmp.add(values[k]);
+		add.stop();
+		if(r == 0)
+			s = std::move(tmp);
+	}
+	add.report(format, type, config, "add", n, double(rounds) * n);
+
+	measure index;
+	std::size_t sum = 0;
+	for(unsigned int r = 0; r < rounds; ++r){
+		index.start();
+		for(unsigned int k = 0, i = 0; k < n; ++k, i = (i + 7919) % n)
+			sum += reinterpret_cast<std::uintptr_t>(&s[i]);
+		index.stop();
+	}
+	index.report(format, type, config, "operator[]", n, double(rounds) * n);
+
+	measure iteration;
+	for(unsigned int r = 0; r < rounds; ++r){
+		iteration.start();
+		for(typename set_type::const_iterator i = s.begin(), ie = s.end(); i != ie; ++i)
+			sum += reinterpret_cast<std::uintptr_t>(&*i);
+		iteration.stop();
+	}
+	iteration.report(format, type, config, "iteration", n, double(rounds) * n);
+
+	measure copy;
+	for(unsigned int r = 0; r < rounds; ++r){
+		copy.start();
+		set_type tmp(s);
+		copy.stop();
+		sum += tmp.size();
+	}
+	copy.report(format, type, config, "copy", n, double(rounds) * n);
+
+	measure assign;
+	for(unsigned int r = 0; r < rounds; ++r){
+		set_type tmp;
+		tmp.add(traits::make(n));
+		assign.start();
+		tmp = s;
+		assign.stop();
+		sum += tmp.size();
+	}
+	assign.report(format, type, config, "operator=", n, double(rounds) * n);
+
+	measure filter;
+	for(unsigned int r = 0; r < rounds; ++r){
+		filter.start();
+		set_type tmp = filter_out(s, typename traits::keep());
+		filter.stop();
+		sum += tmp.size();
+	}
+	filter.report(format, type, config, "filter_out", n, double(rounds) * n);
+
+	set_type other;
+	for(unsigned int k = n + 1; k <= 2 * n; ++k)
+		other.add(traits::make(k));
+	measure concat;
+	for(unsigned int r = 0; r < rounds; ++r){
+		concat.start();
+		set_type tmp = s + other;
+		concat.stop();
+		sum += tmp.size();
+	}
+	concat.report(format, type, config, "operator+", n, double(rounds) * 2 * n);
+
+	measure remove;
+	for(unsigned int r = 0; r < rounds; ++r){
+		set_type tmp(s);
+		remove.start();
+		for(unsigned int k = 0; k < n; ++k)
+			tmp.remove(values[k]);
+		remove.stop();
+	}
+	remove.report(format, type, config, "remove", n, double(rounds) * n);
+
+	if(sum == 1)
+		std::fprintf(stderr, "\n");
+}
+
+/**
+	@brief Esegue bench_type in un processo figlio
+
+	@param format Formato dei risultati.
+	@param config Nome della configurazione dell'indice (hash o linear).
+	@param n Numero di elementi.
+**/
+template <typename T, typename S>
+void run_isolated(output_format format, const char *config, unsigned int n){
+
+	std::fflush(stdout);
+	pid_t pid = fork();
+	if(pid == 0){
+		bench_type<T, S>(format, config, n);
+		std::fflush(stdout);
+		_exit(0);
+	}
+
+	int status = 0;
+	if(pid < 0 || waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		std::fprintf(stderr, "%s (%s), %u elements: failed\n", element_traits<T>::name(), config, n);
+}
+
+int main(int argc, char *argv[]){
+
+	output_format format = csv;
+	unsigned int max_size = 10000000;
+
+	if(argc > 1 && std::strcmp(argv[1], "json") == 0)
+		format = json;
+	if(argc > 2)
+		max_size = static_cast<unsigned int>(std::strtoul(argv[2], 0, 10));
+
+	if(format == csv)
+		std::printf("type,index,op,elements,ns_per_op,allocs_per_op,peak_rss_kb\n");
+
+	for(unsigned int n = 10; n <= max_size; n *= 10){
+		run_isolated<int, element_traits<int>::set_type>(format, "hash", n);
+		run_isolated<std::string, element_traits<std::string>::set_type>(format, "hash", n);
+		run_isolated<voce, element_traits<voce>::set_type>(format, "hash", n);
+		if(n <= linear_max_size){
+			run_isolated<int, element_traits<int>::linear_set_type>(format, "linear", n);
+			run_isolated<std::string, element_traits<std::string>::linear_set_type>(format, "linear", n);
+			run_isolated<voce, element_traits<voce>::linear_set_type>(format, "linear", n);
+		}
+	}
+	return 0;
+}
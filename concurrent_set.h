@@ -0,0 +1,548 @@
+#ifndef CONCURRENT_SET_H
+#define CONCURRENT_SET_H
+
+#include "set.h"	//already_existing_exception, hash_index
+#include "epoch.h"	//epoch_domain
+#include <atomic>	//atomic
+#include <shared_mutex>	//shared_mutex
+#include <mutex>	//unique_lock
+#include <memory>	//unique_ptr
+#include <functional>	//hash
+
+/**
+	@file concurrent_set.h
+	@brief Dichiarazione della classe concurrent_set
+**/
+
+/**
+	@brief Set utilizzabile da più thread contemporaneamente
+
+	Classe che rappresenta un set di elementi di tipo T utilizzabile
+	contemporaneamente da più thread lettori e scrittori, senza lock esterni.
+	Gli elementi sono ripartiti per hash su un insieme di stripe indipendenti;
+	ogni stripe ha il proprio lock (condiviso per le ricerche, esclusivo per
+	inserimenti e rimozioni), la propria lista di nodi e il proprio indice hash,
+	quindi operazioni su stripe diverse non si bloccano a vicenda.
+	L'iterazione non usa lock: i nodi rimossi vengono distrutti tramite epoch_domain
+	solo quando nessun const_iterator può più raggiungerli, per cui un iteratore
+	resta valido anche se l'elemento a cui si riferisce viene rimosso da un altro thread.
+	L'ordine di iterazione non è quello di inserimento.
+	@param T Tipo degli elementi.
+	@param Eql Funtore per l'uguaglianza tra elementi.
+	@param Hash Funtore di hash, di default std::hash<T>.
+**/
+template <typename T, typename Eql, typename Hash = std::hash<T> >
+class concurrent_set{
+
+	typedef std::size_t size_type;
+
+	/**
+		@brief Nodo di una stripe
+
+		Il puntatore next è atomico perché viene letto senza lock dagli iteratori;
+		previous viene usato solo dagli scrittori, sotto il lock della stripe.
+	**/
+	struct node{
+		T value;	///< Elemento
+		std::size_t hash;	///< Hash dell'elemento
+		std::atomic<node *> next;	///< Nodo successivo nella stripe
+		node *previous;	///< Nodo precedente nella stripe
+
+		template <typename V>
+		node(V &&v, std::size_t h) : value(std::forward<V>(v)), hash(h), next(0), previous(0) {}
+	};
+
+	/**
+		@brief Partizione del set
+
+		Ogni stripe occupa una propria linea di cache, in modo che i lock
+		di stripe diverse non interferiscano tra loro.
+	**/
+	struct alignas(64) stripe{
+		mutable std::shared_mutex lock;	///< Lock della stripe
+		std::atomic<node *> head;	///< Primo nodo della stripe
+		node *tail;	///< Ultimo nodo della stripe
+		set_detail::hash_index<node *> index;	///< Indice hash dei nodi della stripe
+
+		stripe() : head(0), tail(0) {}
+	};
+
+	std::unique_ptr<stripe[]> _stripes;	///< Stripe del set
+	std::size_t _mask;	///< Numero di stripe - 1
+	std::atomic<size_type> _size;	///< Numero di elementi
+	Eql _equal;	///< Funtore per l'uguaglianza
+	Hash _hasher;	///< Funtore di hash
+
+	/**
+		@brief Stripe di un hash
+
+		Rimescola l'hash prima di selezionare la stripe: l'indice di ogni stripe
+		usa i bit alti dell'hash, la selezione della stripe quelli bassi.
+		@param hash Hash dell'elemento.
+		@return La stripe a cui appartiene l'elemento.
+	**/
+	stripe &stripe_of(std::size_t hash) const{
+
+		std::uint64_t x = hash;
+		x ^= x >> 33;
+		x *= 0xff51afd7ed558ccdull;
+		x ^= x >> 33;
+		return _stripes[static_cast<std::size_t>(x) & _mask];
+	}
+
+	/**
+		@brief Ricerca di un elemento in una stripe
+
+		@pre Il chiamante deve possedere il lock della stripe.
+		@param s Stripe in cui cercare.
+		@param v Elemento da cercare.
+		@param hash Hash dell'elemento.
+		@return Il nodo trovato, oppure 0.
+	**/
+	node *search(const stripe &s, const T &v, std::size_t hash) const{
+		return s.index.find(hash, [&](node *n){ return _equal(n->value, v); });
+	}
+
+	/**
+		@brief Funzione di supporto per l'inserimento di un elemento
+
+		@param v Elemento da inserire.
+		@return true se l'elemento è stato inserito, false se era già presente.
+	**/
+	template <typename V>
+	bool add_value(V &&v){
+
+		std::size_t hash = _hasher(v);
+		stripe &s = stripe_of(hash);
+		std::unique_lock<std::shared_mutex> guard(s.lock);
+
+		if(search(s, v, hash) != 0)
+			return false;
+
+		node *n = new node(std::forward<V>(v), hash);
+		try{
+			s.index.insert(hash, n);
+		}
+		catch(...){
+			delete n;
+			throw;
+		}
+
+		n->previous = s.tail;
+		if(s.tail != 0)
+			s.tail->next.store(n, std::memory_order_release);
+		else
+			s.head.store(n, std::memory_order_release);
+		s.tail = n;
+
+		_size.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	/**
+		@brief Stacca un nodo dalla lista della stripe
+
+		Il puntatore next del nodo staccato non viene modificato, in modo che
+		un iteratore posizionato sul nodo possa proseguire.
+		@pre Il chiamante deve possedere il lock esclusivo della stripe.
+		@param s Stripe del nodo.
+		@param n Nodo da staccare.
+	**/
+	static void unlink(stripe &s, node *n){
+
+		node *next = n->next.load(std::memory_order_relaxed);
+
+		if(n->previous != 0)
+			n->previous->next.store(next, std::memory_order_release);
+		else
+			s.head.store(next, std::memory_order_release);
+
+		if(next != 0)
+			next->previous = n->previous;
+		else
+			s.tail = n->previous;
+	}
+
+public:
+	/**
+		@brief Costruttore secondario
+
+		Costruttore secondario. Permette di istanziare un set vuoto.
+		@param stripes Numero di stripe, arrotondato alla potenza di 2 successiva.
+		Un numero di stripe pari ad alcune volte il numero di thread scrittori
+		rende rara la contesa dei lock.
+	**/
+	explicit concurrent_set(size_type stripes = 64) : _size(0) {
+
+		std::size_t count = 1;
+		while(count < stripes)
+			count <<= 1;
+
+		_stripes.reset(new stripe[count]);
+		_mask = count - 1;
+	}
+
+	concurrent_set(const concurrent_set &other) = delete;
+	concurrent_set &operator=(const concurrent_set &other) = delete;
+
+	/**
+		@brief Distruttore
+
+		Distrugge tutti gli elementi del set.
+		@pre Nessun altro thread deve usare il set o suoi iteratori.
+	**/
+	~concurrent_set(){
+
+		for(std::size_t i = 0; i <= _mask; ++i){
+			node *n = _stripes[i].head.load(std::memory_order_relaxed);
+			while(n != 0){
+				node *next = n->next.load(std::memory_order_relaxed);
+				delete n;
+				n = next;
+			}
+		}
+	}
+
+	/**
+		@brief Aggiunge un elemento al set
+
+		@param v Elemento da aggiungere.
+		@throw already_existing_exception Eccezione che viene lanciata
+		se l'elemento è già presente nel set.
+	**/
+	void add(const T &v){
+		if(!add_value(v))
+			throw already_existing_exception();
+	}
+
+	/**
+		@brief Aggiunge un elemento al set (per spostamento)
+
+		@param v Elemento da aggiungere.
+		@throw already_existing_exception Eccezione che viene lanciata
+		se l'elemento è già presente nel set.
+	**/
+	void add(T &&v){
+		if(!add_value(std::move(v)))
+			throw already_existing_exception();
+	}
+
+	/**
+		@brief Aggiunge un elemento al set se non già presente
+
+		@param v Elemento da aggiungere.
+		@return true se l'elemento è stato aggiunto, false se era già presente.
+	**/
+	bool try_add(const T &v){
+		return add_value(v);
+	}
+
+	/**
+		@brief Aggiunge un elemento al set se non già presente (per spostamento)
+
+		@param v Elemento da aggiungere.
+		@return true se l'elemento è stato aggiunto, false se era già presente.
+	**/
+	bool try_add(T &&v){
+		return add_value(std::move(v));
+	}
+
+	/**
+		@brief Rimuove un elemento dal set se presente
+
+		La memoria dell'elemento viene liberata solo quando nessun
+		const_iterator può più raggiungerlo.
+		@param v Elemento da rimuovere.
+		@return true se l'elemento è stato rimosso, false se non era presente.
+	**/
+	bool try_remove(const T &v){
+
+		std::size_t hash = _hasher(v);
+		stripe &s = stripe_of(hash);
+		node *n;
+		{
+			std::unique_lock<std::shared_mutex> guard(s.lock);
+
+			n = search(s, v, hash);
+			if(n == 0)
+				return false;
+
+			s.index.erase(hash, n);
+			unlink(s, n);
+		}
+
+		_size.fetch_sub(1, std::memory_order_relaxed);
+		epoch_domain::instance().retire(n);
+		return true;
+	}
+
+	/**
+		@brief Rimuove un elemento dal set
+
+		@param v Elemento da rimuovere.
+		@throw not_existing_exception Eccezione che viene lanciata
+		se l'elemento non è presente nel set.
+	**/
+	void remove(const T &v){
+		if(!try_remove(v))
+			throw not_existing_exception();
+	}
+
+	/**
+		@brief Verifica la presenza di un elemento
+
+		@param v Elemento da cercare.
+		@return true se l'elemento è presente nel set.
+	**/
+	bool contains(const T &v) const{
+
+		std::size_t hash = _hasher(v);
+		const stripe &s = stripe_of(hash);
+		std::shared_lock<std::shared_mutex> guard(s.lock);
+
+		return search(s, v, hash) != 0;
+	}
+
+	/**
+		@brief Svuota il set
+
+		Le stripe vengono svuotate una alla volta: un thread che inserisce
+		elementi durante lo svuotamento può ritrovarli nel set al termine.
+	**/
+	void clear_set(void){
+
+		for(std::size_t i = 0; i <= _mask; ++i){
+			stripe &s = _stripes[i];
+			size_type removed = 0;
+			{
+				std::unique_lock<std::shared_mutex> guard(s.lock);
+
+				node *n = s.head.load(std::memory_order_relaxed);
+				s.head.store(0, std::memory_order_release);
+				s.tail = 0;
+				s.index.reset();
+
+				while(n != 0){
+					node *next = n->next.load(std::memory_order_relaxed);
+					epoch_domain::instance().retire(n);
+					n = next;
+					removed++;
+				}
+			}
+			_size.fetch_sub(removed, std::memory_order_relaxed);
+		}
+	}
+
+	/**
+		@brief Numero di elementi nel set
+
+		Con scritture concorrenti il valore può essere già superato al ritorno.
+		@return Il numero di elementi nel set.
+	**/
+	size_type size(void) const{
+		return _size.load(std::memory_order_relaxed);
+	}
+
+	/**
+		@brief Definizione della classe const_iterator
+
+		Classe che implementa iteratori di tipo costante utilizzabili nella classe
+		concurrent_set. Un iteratore che non ha raggiunto la fine fissa l'epoca
+		corrente, impedendo la distruzione dei nodi rimossi dopo la sua creazione:
+		va quindi usato dal thread che lo ha creato e non va conservato a lungo.
+		L'iterazione visita ogni elemento presente per tutta la sua durata una sola
+		volta; gli elementi aggiunti o rimossi nel frattempo possono essere visitati o no.
+	**/
+	class const_iterator {
+		const concurrent_set *c;
+		std::size_t s;
+		node *n;
+
+		/**
+			@brief Avanza fino al primo nodo disponibile
+
+			Se il nodo corrente è nullo passa alle stripe successive;
+			raggiunta la fine rilascia l'epoca.
+		**/
+		void settle(void){
+			while(n == 0 && s < c->_mask){
+				++s;
+				n = c->_stripes[s].head.load(std::memory_order_acquire);
+			}
+			if(n == 0)
+				epoch_domain::instance().unpin();
+		}
+
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef T                         value_type;
+		typedef ptrdiff_t                 difference_type;
+		typedef const T*                  pointer;
+		typedef const T&                  reference;
+
+		/**
+			@brief Costruttore di default
+
+			Costruttore di default per istanziare un const_iterator.
+		**/
+		const_iterator() : c(0), s(0), n(0){}
+
+		/**
+			@brief Costruttore secondario (COSTRUTTORE DI COPIA)
+
+			Costruttore secondario. Permette di creare un const_iterator
+			come copia di un altro const_iterator.
+			@param other Const_iterator sorgente.
+		**/
+		const_iterator(const const_iterator &other) : c(other.c), s(other.s), n(other.n){
+			if(n != 0)
+				epoch_domain::instance().pin();
+		}
+
+		/**
+			@brief Operatore di assegnamento
+
+			Operatore di assegnamento. Permette la copia tra const_iterator.
+			@param other Const_iterator sorgente.
+			@return Riferimento a this.
+		**/
+		const_iterator& operator=(const const_iterator &other) {
+			if(other.n != 0)
+				epoch_domain::instance().pin();
+			if(n != 0)
+				epoch_domain::instance().unpin();
+			c = other.c;
+			s = other.s;
+			n = other.n;
+			return *this;
+		}
+
+		/**
+			@brief Distruttore
+
+			Distrugge il const_iterator al termine dell'utilizzo.
+		**/
+		~const_iterator() {
+			if(n != 0)
+				epoch_domain::instance().unpin();
+		}
+
+		/**
+			@brief Operatore di dereferenziamento
+
+			Operatore di dereferenziamento. Ritorna il dato riferito dall'iteratore.
+			@return Il dato riferito dall'iteratore.
+		**/
+		reference operator*() const {
+			return n->value;
+		}
+
+		/**
+			@brief Operatore freccia
+
+			Operatore freccia. Ritorna il puntatore al dato riferito dall'iteratore
+			@return Il puntatore al dato riferito dall'iteratore
+		**/
+		pointer operator->() const {
+			return &(n->value);
+		}
+
+		/**
+			@brief Operatore di iterazione post-incremento
+
+			Operatore di iterazione post-incremento. Incrementa il const_iteratore
+			ma ne ritorna la copia non iterata.
+			@return La copia del const_iterator.
+		**/
+		const_iterator operator++(int) {
+
+			const_iterator tmp(*this);
+			++(*this);
+			return tmp;
+		}
+
+		/**
+			@brief Operatore di iterazione pre-incremento
+
+			Operatore di iterazione pre-incremento. Incrementa il const_iteratore
+			ma ne ritorna il riferimento
+			@return Il riferimento al const_iterator.
+		**/
+		const_iterator& operator++() {
+			n = n->next.load(std::memory_order_acquire);
+			settle();
+			return *this;
+		}
+
+		/**
+			@brief Operatore di uguaglianza
+
+			Operatore di uguaglianza. Esegue una comparazione tra due const_iterator,
+			se sono uguali restituisce true, altrimenti restituisce false.
+			@param other Il const_iterator con cui effettuare la comparazione.
+			@return Il risultato della comparazione di due const_iterator.
+		**/
+		bool operator==(const const_iterator &other) const {
+			return (n==other.n);
+		}
+
+		/**
+			@brief Operatore di diversità
+
+			Operatore di diversità. Esegue una comparazione tra due const_iterator,
+			se sono diversi restituisce true, altrimenti restituisce false.
+			@param other Il const_iterator con cui effettuare la comparazione.
+			@return Il risultato della comparazione di due const_iterator.
+		**/
+		bool operator!=(const const_iterator &other) const {
+			return (n!=other.n);
+		}
+
+	private:
+
+		friend class concurrent_set;
+		explicit const_iterator(const concurrent_set *cc) : c(cc), s(0), n(0){
+			epoch_domain::instance().pin();
+			n = c->_stripes[0].head.load(std::memory_order_acquire);
+			settle();
+		}
+	}; // classe const_iterator
+
+	/**
+		@brief Iteratore all'inizio della sequenza di dati
+
+		@return L'iteratore all'inizio della sequenza di dati.
+	**/
+	const_iterator begin() const {
+		return const_iterator(this);
+	}
+
+	/**
+		@brief Iteratore alla fine della sequenza di dati
+
+		@return L'iteratore alla fine della sequenza di dati.
+	**/
+	const_iterator end() const {
+		return const_iterator();
+	}
+};
+
+/**
+	@brief Operatore di stream
+
+	Permette di spedire su uno stream di output il contenuto del concurrent_set.
+	@param os stream di output
+	@param data_set Set sorgente i cui elementi verranno spediti sullo stream.
+	@return Il riferimento allo stream di output.
+**/
+template <typename T, typename Eql, typename Hash>
+std::ostream &operator<<(std::ostream &os, const concurrent_set<T, Eql, Hash> &data_set){
+
+	typename concurrent_set<T, Eql, Hash>::const_iterator i, ie;
+
+	for(i=data_set.begin(), ie=data_set.end(); i!=ie; ++i)
+		os << *i << " ";
+	return os;
+}
+
+#endif
@@ -0,0 +1,261 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include <atomic>	//atomic
+#include <cstdint>	//uint64_t
+#include <mutex>	//mutex
+#include <vector>	//vector
+
+/**
+	@file epoch.h
+	@brief Dichiarazione del meccanismo di reclamation basato su epoche
+**/
+
+/**
+	@brief Dominio di reclamation basato su epoche
+
+	Classe che permette di liberare in modo sicuro la memoria di oggetti rimossi da una
+	struttura dati condivisa mentre altri thread potrebbero ancora leggerli.
+	Un thread lettore "fissa" l'epoca corrente (pin) prima di accedere alla struttura
+	e la rilascia (unpin) al termine; un oggetto rimosso viene "ritirato" (retire)
+	insieme all'epoca in cui è avvenuta la rimozione, e viene distrutto solo quando
+	tutti i thread che hanno fissato un'epoca non successiva hanno terminato la lettura.
+	Pin e unpin non usano lock e sono wait-free dopo la prima chiamata di ogni thread.
+	Esiste un unico dominio per processo, ottenuto con instance().
+**/
+class epoch_domain{
+
+	/**
+		@brief Stato di un thread
+
+		Struttura che contiene l'epoca fissata da un thread (0 se nessuna).
+		I record non vengono mai deallocati prima del dominio: quando un thread
+		termina il suo record viene liberato e riutilizzato da altri thread.
+	**/
+	struct record{
+		std::atomic<std::uint64_t> epoch;	///< Epoca fissata dal thread, 0 se il thread non sta leggendo
+		std::atomic<bool> in_use;	///< Vero se il record è assegnato ad un thread
+		unsigned int depth;	///< Numero di pin annidati (usato solo dal thread proprietario)
+		record *next;	///< Record successivo nella lista dei record
+
+		record() : epoch(0), in_use(true), depth(0), next(0) {}
+	};
+
+	/**
+		@brief Oggetto ritirato
+
+		Struttura che contiene un oggetto in attesa di essere distrutto.
+	**/
+	struct retired{
+		void *ptr;	///< Puntatore all'oggetto
+		void (*deleter)(void *);	///< Funzione che distrugge l'oggetto
+		std::uint64_t epoch;	///< Epoca in cui l'oggetto è stato ritirato
+	};
+
+	/**
+		@brief Record del thread corrente
+
+		Struttura thread_local che rilascia il record quando il thread termina.
+	**/
+	struct thread_slot{
+		record *r;	///< Record assegnato al thread
+
+		thread_slot() : r(0) {}
+		~thread_slot(){
+			if(r != 0)
+				r->in_use.store(false, std::memory_order_release);
+		}
+	};
+
+	std::atomic<std::uint64_t> _epoch;	///< Epoca globale corrente (parte da 1)
+	std::atomic<record *> _records;	///< Lista dei record dei thread
+	std::mutex _retired_lock;	///< Lock della lista degli oggetti ritirati
+	std::vector<retired> _retired;	///< Oggetti ritirati non ancora distrutti
+
+	epoch_domain() : _epoch(1), _records(0) {}
+
+	epoch_domain(const epoch_domain &other) = delete;
+	epoch_domain &operator=(const epoch_domain &other) = delete;
+
+	~epoch_domain(){
+		for(std::size_t i = 0; i < _retired.size(); ++i)
+			_retired[i].deleter(_retired[i].ptr);
+
+		record *r = _records.load();
+		while(r != 0){
+			record *next = r->next;
+			delete r;
+			r = next;
+		}
+	}
+
+	/**
+		@brief Record del thread corrente
+
+		Al primo utilizzo da parte di un thread viene riutilizzato un record
+		libero, oppure ne viene creato uno nuovo.
+		@return Il record del thread corrente.
+	**/
+	record &local(void){
+
+		static thread_local thread_slot slot;
+
+		if(slot.r == 0){
+			for(record *r = _records.load(std::memory_order_acquire); r != 0; r = r->next){
+				bool expected = false;
+				if(!r->in_use.load(std::memory_order_relaxed) &&
+					r->in_use.compare_exchange_strong(expected, true)){
+					slot.r = r;
+					return *r;
+				}
+			}
+			record *r = new record;
+			r->next = _records.load(std::memory_order_relaxed);
+			while(!_records.compare_exchange_weak(r->next, r))
+				;
+			slot.r = r;
+		}
+		return *slot.r;
+	}
+
+	/**
+		@brief Distrugge gli oggetti non più raggiungibili
+
+		Distrugge gli oggetti ritirati prima dell'epoca più vecchia fissata dai thread
+		e fa avanzare l'epoca globale.
+		@pre Il chiamante deve possedere _retired_lock.
+	**/
+	void collect(void){
+
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		std::uint64_t oldest = ~std::uint64_t(0);
+		for(record *r = _records.load(std::memory_order_acquire); r != 0; r = r->next){
+			std::uint64_t e = r->epoch.load(std::memory_order_acquire);
+			if(e != 0 && e < oldest)
+				oldest = e;
+		}
+
+		std::size_t w = 0;
+		for(std::size_t i = 0; i < _retired.size(); ++i)
+			if(_retired[i].epoch < oldest)
+				_retired[i].deleter(_retired[i].ptr);
+			else
+				_retired[w++] = _retired[i];
+		_retired.resize(w);
+
+		_epoch.fetch_add(1);
+	}
+
+public:
+	/**
+		@brief Dominio del processo
+
+		@return Il riferimento all'unico dominio di reclamation del processo.
+	**/
+	static epoch_domain &instance(void){
+		static epoch_domain domain;
+		return domain;
+	}
+
+	/**
+		@brief Fissa l'epoca corrente
+
+		Da chiamare prima di leggere una struttura condivisa. I pin possono
+		essere annidati: solo il più esterno fissa l'epoca.
+	**/
+	void pin(void){
+
+		record &r = local();
+
+		if(r.depth++ == 0){
+			r.epoch.store(_epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+		}
+	}
+
+	/**
+		@brief Rilascia l'epoca fissata
+
+		Da chiamare al termine della lettura, una volta per ogni pin.
+	**/
+	void unpin(void){
+
+		record &r = local();
+
+		if(--r.depth == 0)
+			r.epoch.store(0, std::memory_order_release);
+	}
+
+	/**
+		@brief Ritira un oggetto
+
+		L'oggetto deve essere già stato reso irraggiungibile dalla struttura condivisa;
+		verrà distrutto con deleter quando nessun thread potrà più leggerlo.
+		@param ptr Puntatore all'oggetto.
+		@param deleter Funzione che distrugge l'oggetto.
+	**/
+	void retire(void *ptr, void (*deleter)(void *)){
+
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		retired item = {ptr, deleter, _epoch.load()};
+
+		std::lock_guard<std::mutex> guard(_retired_lock);
+		_retired.push_back(item);
+		if(_retired.size() >= 128)
+			collect();
+	}
+
+	/**
+		@brief Ritira un oggetto allocato con new
+
+		@param ptr Puntatore all'oggetto, che verrà distrutto con delete.
+	**/
+	template <typename T>
+	void retire(T *ptr){
+		retire(ptr, [](void *p){ delete static_cast<T *>(p); });
+	}
+
+	/**
+		@brief Distrugge subito gli oggetti non più raggiungibili
+
+		Utile ad esempio al termine di una fase di scrittura intensa.
+	**/
+	void flush(void){
+		std::lock_guard<std::mutex> guard(_retired_lock);
+		collect();
+		collect();
+	}
+};
+
+/**
+	@brief Pin dell'epoca con durata di scope
+
+	Classe che fissa l'epoca corrente alla costruzione e la rilascia
+	alla distruzione.
+**/
+class epoch_guard{
+public:
+	/**
+		@brief Costruttore di default
+
+		Fissa l'epoca corrente.
+	**/
+	epoch_guard(){
+		epoch_domain::instance().pin();
+	}
+
+	epoch_guard(const epoch_guard &other) = delete;
+	epoch_guard &operator=(const epoch_guard &other) = delete;
+
+	/**
+		@brief Distruttore
+
+		Rilascia l'epoca fissata.
+	**/
+	~epoch_guard(){
+		epoch_domain::instance().unpin();
+	}
+};
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef FIXED_SET_H
+#define FIXED_SET_H
+
+#include "set.h"	//already_existing_exception
+#include <cstddef>	//size_t
+#include <functional>	//equal_to
+#include <ostream>	//ostream
+
+/**
+	@file fixed_set.h
+	@brief Dichiarazione della classe fixed_set
+**/
+
+/**
+	@brief Set di dimensione fissa utilizzabile a tempo di compilazione
+
+	Classe che rappresenta un piccolo set immutabile i cui elementi sono noti alla
+	costruzione, pensata per tabelle di appartenenza note a tempo di compilazione
+	(es. parole chiave, codici ammessi). Gli elementi sono memorizzati in un array
+	interno, senza allocazioni, e la ricerca è una scansione lineare: con tipi
+	letterali e un funtore Eql constexpr (come std::equal_to) sia la costruzione
+	sia la ricerca possono essere valutate dal compilatore.
+	Un elemento duplicato lancia already_existing_exception; in un contesto
+	constexpr rende il programma non compilabile.
+	@param T Tipo degli elementi.
+	@param N Numero di elementi.
+	@param Eql Funtore per l'uguaglianza tra elementi.
+**/
+template <typename T, std::size_t N, typename Eql = std::equal_to<T> >
+class fixed_set{
+
+	static_assert(N > 0, "fixed_set: N must be positive");
+
+	T _values[N];	///< Elementi, nell'ordine di costruzione
+
+public:
+	typedef std::size_t size_type;	///< Definzione del tipo corrispondente a size
+	typedef const T *const_iterator;	///< Gli elementi sono contigui: l'iteratore è un puntatore
+
+	/**
+		@brief Costruttore secondario
+
+		Costruttore secondario. Permette di creare un set a partire dai suoi N elementi.
+		@param values Gli elementi del set.
+		@throw already_existing_exception Eccezione che viene lanciata
+		in caso di elementi duplicati.
+	**/
+	template <typename... V, typename = typename std::enable_if<sizeof...(V) == N>::type>
+	constexpr explicit fixed_set(const V &... values) : _values{static_cast<T>(values)...} {
+
+		for(size_type i = 1; i < N; ++i)
+			for(size_type j = 0; j < i; ++j)
+				if(Eql()(_values[i], _values[j]))
+					throw already_existing_exception();
+	}
+
+	/**
+		@brief Verifica la presenza di un elemento
+
+		@param v Elemento da cercare.
+		@return true se l'elemento è presente.
+	**/
+	constexpr bool contains(const T &v) const{
+
+		for(size_type i = 0; i < N; ++i)
+			if(Eql()(_values[i], v))
+				return true;
+		return false;
+	}
+
+	/**
+		@brief Accesso in sola lettura all'elemento i-esimo
+
+		@param i Posizione dell'elemento, nell'ordine di costruzione.
+		@return Il riferimento costante all'elemento.
+	**/
+	constexpr const T &operator[](size_type i) const{
+		return _values[i];
+	}
+
+	/**
+		@brief Numero di elementi
+
+		@return Il numero di elementi.
+	**/
+	constexpr size_type size(void) const{
+		return N;
+	}
+
+	/**
+		@brief Iteratore all'inizio della sequenza di dati
+
+		@return L'iteratore all'inizio della sequenza di dati.
+	**/
+	constexpr const_iterator begin() const {
+		return _values;
+	}
+
+	/**
+		@brief Iteratore alla fine della sequenza di dati
+
+		@return L'iteratore alla fine della sequenza di dati.
+	**/
+	constexpr const_iterator end() const {
+		return _values + N;
+	}
+};
+
+/**
+	@brief Crea un fixed_set dagli elementi
+
+	Il tipo degli elementi è quello del primo argomento.
+	@param first Primo elemento.
+	@param rest Elementi successivi.
+	@return Un fixed_set con gli elementi dati.
+**/
+template <typename T, typename... V>
+constexpr fixed_set<T, 1 + sizeof...(V)> make_fixed_set(const T &first, const V &... rest){
+	return fixed_set<T, 1 + sizeof...(V)>(first, rest...);
+}
+
+/**
+	@brief Operatore di stream
+
+	Permette di spedire su uno stream di output il contenuto del fixed_set.
+	@param os stream di output
+	@param data_set Set sorgente i cui elementi verranno spediti sullo stream.
+	@return Il riferimento allo stream di output.
+**/
+template <typename T, std::size_t N, typename Eql>
+std::ostream &operator<<(std::ostream &os, const fixed_set<T, N, Eql> &data_set){
+
+	typename fixed_set<T, N, Eql>::const_iterator i, ie;
+
+	for(i=data_set.begin(), ie=data_set.end(); i!=ie; ++i)
+		os << *i << " ";
+	return os;
+}
+
+#endif
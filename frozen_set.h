@@ -0,0 +1,338 @@
+#ifndef FROZEN_SET_H
+#define FROZEN_SET_H
+
+#include "set.h"	//set, no_hash
+#include "epoch.h"	//epoch_domain
+#include <atomic>	//atomic
+#include <cstdint>	//uint32_t
+#include <vector>	//vector
+#include <utility>	//move
+#include <stdexcept>	//length_error
+
+/**
+	@file frozen_set.h
+	@brief Dichiarazione delle classi frozen_set e snapshot_handle
+**/
+
+/**
+	@brief Copia immutabile di un set ottimizzata per la ricerca
+
+	Classe che rappresenta una fotografia non modificabile di un set. Gli elementi
+	sono memorizzati in un array contiguo, nello stesso ordine del set di origine,
+	insieme al loro hash; l'indice è una tabella ad indirizzamento aperto di posizioni
+	a 32 bit con fattore di carico massimo 0.5, per cui una ricerca tocca in media
+	una cella dell'indice e un solo elemento.
+	Con Hash uguale a no_hash l'indice non viene costruito e la ricerca scandisce l'array.
+	Con l'indice abilitato il set di origine può contenere al più 2^32 - 2 elementi.
+	Essendo immutabile, un frozen_set può essere letto da più thread senza lock.
+	@param T Tipo degli elementi.
+	@param Eql Funtore per l'uguaglianza tra elementi.
+	@param Hash Funtore di hash, oppure no_hash.
+**/
+template <typename T, typename Eql, typename Hash = no_hash>
+class frozen_set{
+
+	typedef std::size_t size_type;	///< Definzione del tipo corrispondente a size
+
+	static const std::size_t max_indexed = 0xfffffffe;	///< Massimo numero di elementi con l'indice a 32 bit
+
+	static const bool hashed = !std::is_same<Hash, no_hash>::value;	///< true se l'indice hash è abilitato
+
+	std::vector<T> _values;	///< Elementi, nell'ordine del set di origine
+	std::vector<std::size_t> _hashes;	///< Hash degli elementi, vuoto con no_hash
+	std::vector<std::uint32_t> _slots;	///< Indice: posizione dell'elemento + 1, 0 se la cella è vuota
+	unsigned int _shift;	///< 64 - log2(numero di celle), usato per il fibonacci hashing
+	Eql _equal;	///< Funtore per l'uguaglianza
+	Hash _hasher;	///< Funtore di hash
+
+	/**
+		@brief Posizione iniziale di un hash nell'indice
+
+		@param hash Hash di cui calcolare la posizione.
+		@return L'indice della prima cella da ispezionare.
+	**/
+	std::size_t home(std::size_t hash) const{
+		return static_cast<std::size_t>(
+			(static_cast<std::uint64_t>(hash) * 11400714819323198485ull) >> _shift);
+	}
+
+	/**
+		@brief Costruisce l'indice
+
+		Calcola gli hash degli elementi e li inserisce in una tabella
+		di almeno il doppio delle celle.
+	**/
+	void build_index(void){
+
+		std::size_t capacity = 8;
+		_shift = 61;
+		while(capacity < _values.size() * 2){
+			capacity <<= 1;
+			_shift--;
+		}
+
+		_hashes.reserve(_values.size());
+		_slots.assign(capacity, 0);
+
+		std::size_t mask = capacity - 1;
+		for(size_type k = 0; k < _values.size(); ++k){
+			std::size_t h = _hasher(_values[k]);
+			_hashes.push_back(h);
+
+			std::size_t i = home(h);
+			while(_slots[i] != 0)
+				i = (i + 1) & mask;
+			_slots[i] = static_cast<std::uint32_t>(k + 1);
+		}
+	}
+
+public:
+	typedef const T *const_iterator;	///< Gli elementi sono contigui: l'iteratore è un puntatore
+
+	/**
+		@brief Costruttore di default
+
+		Costruttore di default per istanziare un frozen_set vuoto.
+	**/
+	frozen_set() : _shift(64) {}
+
+	/**
+		@brief Costruttore secondario
+
+		Costruttore secondario. Copia gli elementi di un set, senza
+		confrontarli tra loro, e costruisce l'indice.
+		@param other Set sorgente.
+		@throw std::length_error Se l'indice è abilitato e other ha più di
+		max_indexed (2^32 - 2) elementi, che le celle a 32 bit non possono riferire.
+	**/
+	template <typename... P>
+	explicit frozen_set(const set<T, Eql, P...> &other) : _shift(64) {
+
+		if(hashed && other.size() > max_indexed)
+			throw std::length_error("frozen_set: too many elements for the 32-bit index");
+
+		_values.reserve(other.size());
+		for(typename set<T, Eql, P...>::const_iterator i = other.begin(), ie = other.end(); i != ie; ++i)
+			_values.push_back(*i);
+
+		if constexpr(hashed)
+			build_index();
+	}
+
+	/**
+		@brief Verifica la presenza di un elemento
+
+		@param v Elemento da cercare.
+		@return true se l'elemento è presente.
+	**/
+	bool contains(const T &v) const{
+
+		if constexpr(hashed){
+			if(_slots.empty())
+				return false;
+
+			std::size_t h = _hasher(v);
+			std::size_t mask = _slots.size() - 1;
+			for(std::size_t i = home(h); _slots[i] != 0; i = (i + 1) & mask){
+				std::uint32_t k = _slots[i] - 1;
+				if(_hashes[k] == h && _equal(_values[k], v))
+					return true;
+			}
+			return false;
+		}
+		else{
+			for(size_type k = 0; k < _values.size(); ++k)
+				if(_equal(_values[k], v))
+					return true;
+			return false;
+		}
+	}
+
+	/**
+		@brief Accesso in sola lettura all'elemento i-esimo
+
+		@param i Posizione dell'elemento, nell'ordine del set di origine.
+		@return Il riferimento costante all'elemento.
+	**/
+	const T &operator[](size_type i) const{
+		assert(i < _values.size());
+		return _values[i];
+	}
+
+	/**
+		@brief Numero di elementi
+
+		@return Il numero di elementi.
+	**/
+	size_type size(void) const{
+		return _values.size();
+	}
+
+	/**
+		@brief Iteratore all'inizio della sequenza di dati
+
+		@return L'iteratore all'inizio della sequenza di dati.
+	**/
+	const_iterator begin() const {
+		return _values.data();
+	}
+
+	/**
+		@brief Iteratore alla fine della sequenza di dati
+
+		@return L'iteratore alla fine della sequenza di dati.
+	**/
+	const_iterator end() const {
+		return _values.data() + _values.size();
+	}
+};
+
+/**
+	@brief Crea la copia immutabile di un set
+
+	@param S Set sorgente.
+	@return Un frozen_set con gli elementi di S, con lo stesso funtore di hash.
+**/
+template <typename T, typename Eql, typename Hash, typename... P>
+frozen_set<T, Eql, Hash> freeze(const set<T, Eql, Hash, P...> &S){
+	return frozen_set<T, Eql, Hash>(S);
+}
+
+/**
+	@brief Operatore di stream
+
+	Permette di spedire su uno stream di output il contenuto del frozen_set.
+	@param os stream di output
+	@param data_set Set sorgente i cui elementi verranno spediti sullo stream.
+	@return Il riferimento allo stream di output.
+**/
+template <typename T, typename Eql, typename Hash>
+std::ostream &operator<<(std::ostream &os, const frozen_set<T, Eql, Hash> &data_set){
+
+	typename frozen_set<T, Eql, Hash>::const_iterator i, ie;
+
+	for(i=data_set.begin(), ie=data_set.end(); i!=ie; ++i)
+		os << *i << " ";
+	return os;
+}
+
+/**
+	@brief Pubblicazione atomica di copie immutabili
+
+	Classe che contiene un puntatore atomico all'ultima versione pubblicata di un
+	oggetto immutabile S (tipicamente un frozen_set). I lettori ottengono la versione
+	corrente con read() senza lock e senza attese; uno scrittore prepara la versione
+	successiva e la sostituisce con publish(). La versione precedente viene distrutta
+	tramite epoch_domain quando l'ultimo lettore che la stava usando ha terminato.
+	@param S Tipo dell'oggetto pubblicato.
+**/
+template <typename S>
+class snapshot_handle{
+
+	std::atomic<S *> _current;	///< Versione corrente, mai nulla
+
+public:
+	/**
+		@brief Accesso in lettura alla versione corrente
+
+		Classe che mantiene valida la versione letta finché esiste: va usata
+		dal thread che l'ha ottenuta e non va conservata a lungo, perché
+		ritarda la distruzione delle versioni sostituite.
+	**/
+	class reader{
+		const S *_snapshot;	///< Versione letta
+
+	public:
+		/**
+			@brief Costruttore secondario
+
+			Costruttore secondario. Fissa l'epoca e legge la versione corrente.
+			@param handle Handle da cui leggere.
+		**/
+		explicit reader(const snapshot_handle &handle){
+			epoch_domain::instance().pin();
+			_snapshot = handle._current.load(std::memory_order_acquire);
+		}
+
+		reader(const reader &other) = delete;
+		reader &operator=(const reader &other) = delete;
+
+		/**
+			@brief Distruttore
+
+			Rilascia l'epoca: la versione letta può essere distrutta.
+		**/
+		~reader(){
+			epoch_domain::instance().unpin();
+		}
+
+		/**
+			@brief Operatore di dereferenziamento
+
+			@return Il riferimento alla versione letta.
+		**/
+		const S &operator*() const{
+			return *_snapshot;
+		}
+
+		/**
+			@brief Operatore freccia
+
+			@return Il puntatore alla versione letta.
+		**/
+		const S *operator->() const{
+			return _snapshot;
+		}
+	};
+
+	/**
+		@brief Costruttore di default
+
+		Costruttore di default. Pubblica un oggetto S costruito di default.
+	**/
+	snapshot_handle() : _current(new S) {}
+
+	/**
+		@brief Costruttore secondario
+
+		Costruttore secondario. Pubblica la versione iniziale.
+		@param initial Versione iniziale.
+	**/
+	explicit snapshot_handle(S &&initial) : _current(new S(std::move(initial))) {}
+
+	snapshot_handle(const snapshot_handle &other) = delete;
+	snapshot_handle &operator=(const snapshot_handle &other) = delete;
+
+	/**
+		@brief Distruttore
+
+		Distrugge la versione corrente.
+		@pre Nessun reader deve essere ancora in uso.
+	**/
+	~snapshot_handle(){
+		delete _current.load(std::memory_order_relaxed);
+	}
+
+	/**
+		@brief Legge la versione corrente
+
+		@return Un reader che mantiene valida la versione corrente.
+	**/
+	reader read(void) const{
+		return reader(*this);
+	}
+
+	/**
+		@brief Pubblica una nuova versione
+
+		I reader già esistenti continuano a vedere la versione precedente.
+		@param next Nuova versione.
+	**/
+	void publish(S &&next){
+
+		S *previous = _current.exchange(new S(std::move(next)), std::memory_order_acq_rel);
+		epoch_domain::instance().retire(previous);
+	}
+};
+
+#endif
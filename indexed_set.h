@@ -0,0 +1,707 @@
+#ifndef INDEXED_SET_H
+#define INDEXED_SET_H
+
+#include "set.h"	//set, list_storage, hash_index, set_access
+#include <ostream>	//operator <<
+#include <cstddef>	//ptrdiff_t
+#include <algorithm>	//find
+#include <iterator>	//forward_iterator_tag
+#include <functional>	//equal_to, hash
+#include <memory>	//unique_ptr, allocator
+#include <utility>	//pair, move
+#include <vector>	//vector
+#include <atomic>	//atomic
+#include <stdexcept>	//invalid_argument
+
+/**
+	@file indexed_set.h
+	@brief Dichiarazione della classe indexed_set
+**/
+
+namespace set_detail{
+
+/**
+	@brief Nuovo identificativo di un indice secondario
+
+	@return Un valore diverso ad ogni chiamata, mai 0.
+**/
+inline std::size_t next_index_id(void){
+	static std::atomic<std::size_t> last(0);
+	return last.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+/**
+	@brief Interfaccia comune degli indici secondari
+
+	Permette all'indexed_set di aggiornare indici su campi di tipo diverso
+	senza conoscerne il tipo. L'identificativo distingue gli indici creati da
+	add_index ed è condiviso dalle loro copie vuote.
+**/
+template <typename T>
+class secondary_index_base{
+	std::size_t _id;	///< Identificativo dell'indice
+
+public:
+	explicit secondary_index_base(std::size_t id) : _id(id) {}
+
+	virtual ~secondary_index_base() {}
+
+	/**
+		@brief Identificativo dell'indice
+
+		@return L'identificativo assegnato da add_index.
+	**/
+	std::size_t id(void) const{
+		return _id;
+	}
+
+	/**
+		@brief Crea un indice vuoto sullo stesso campo
+
+		@return Un nuovo indice vuoto, di proprietà del chiamante.
+	**/
+	virtual secondary_index_base *clone_empty(void) const = 0;
+
+	/**
+		@brief Aggiunge un elemento all'indice
+
+		@param v Puntatore all'elemento, che deve restare allo stesso indirizzo
+		finché è presente nell'indice.
+	**/
+	virtual void insert(const T *v) = 0;
+
+	/**
+		@brief Rimuove un elemento dall'indice
+
+		@pre L'elemento deve essere presente nell'indice.
+		@param v Puntatore all'elemento.
+	**/
+	virtual void erase(const T *v) = 0;
+
+	/**
+		@brief Svuota l'indice
+	**/
+	virtual void clear(void) = 0;
+};
+
+/**
+	@brief Indice secondario su un campo degli elementi
+
+	Raggruppa gli elementi per valore del campo member: ogni gruppo contiene i puntatori
+	agli elementi con la stessa chiave, nell'ordine di inserimento, e un hash_index
+	associa l'hash della chiave alla posizione del gruppo. La ricerca di una chiave
+	costa quanto una ricerca nel set; la rimozione di un elemento scorre il suo gruppo.
+	@param T Tipo degli elementi.
+	@param K Tipo del campo.
+	@param KHash Funtore di hash per il campo.
+	@param KEql Funtore per l'uguaglianza tra campi.
+**/
+template <typename T, typename K, typename KHash, typename KEql>
+class secondary_index : public secondary_index_base<T>{
+
+	static const std::size_t no_group = static_cast<std::size_t>(-1);	///< Posizione che identifica una cella vuota
+
+	/**
+		@brief Elementi con la stessa chiave
+	**/
+	struct group{
+		std::size_t hash;	///< Hash della chiave
+		std::vector<const T *> members;	///< Elementi, mai vuoto
+	};
+
+	K T::*_member;	///< Campo indicizzato
+	KHash _hash;	///< Funtore di hash
+	KEql _equal;	///< Funtore di uguaglianza
+	std::vector<group> _groups;	///< Gruppi, in ordine qualsiasi
+	hash_index<std::size_t> _index;	///< Indice hash delle posizioni dei gruppi
+
+	/**
+		@brief Ricerca del gruppo di una chiave
+
+		@param key Chiave da cercare.
+		@param h Hash della chiave.
+		@return La posizione del gruppo, oppure no_group.
+	**/
+	std::size_t search(const K &key, std::size_t h) const{
+		return _index.find(h, [&](std::size_t g){
+			return _equal(_groups[g].members.front()->*_member, key);
+		});
+	}
+
+public:
+	/**
+		@brief Costruttore secondario
+
+		@param member Campo da indicizzare.
+		@param id Identificativo dell'indice.
+	**/
+	secondary_index(K T::*member, std::size_t id) : secondary_index_base<T>(id),
+		_member(member), _hash(), _equal(), _index(no_group) {}
+
+	secondary_index_base<T> *clone_empty(void) const{
+		return new secondary_index(_member, this->id());
+	}
+
+	/**
+		@brief Elementi con una chiave
+
+		@param key Chiave da cercare.
+		@return L'intervallo dei puntatori agli elementi il cui campo è uguale a key,
+		vuoto (0, 0) se non ce ne sono.
+	**/
+	std::pair<const T * const *, const T * const *> equal_range(const K &key) const{
+
+		std::size_t g = search(key, _hash(key));
+		if(g == no_group)
+			return std::pair<const T * const *, const T * const *>(0, 0);
+
+		const std::vector<const T *> &m = _groups[g].members;
+		return std::pair<const T * const *, const T * const *>(m.data(), m.data() + m.size());
+	}
+
+	void insert(const T *v){
+
+		const K &key = v->*_member;
+		std::size_t h = _hash(key);
+		std::size_t g = search(key, h);
+
+		if(g != no_group){
+			_groups[g].members.push_back(v);
+			return;
+		}
+
+		_index.reserve(_index.size() + 1);
+		_groups.emplace_back();
+		_groups.back().hash = h;
+		try{
+			_groups.back().members.push_back(v);
+		}catch(...){
+			_groups.pop_back();
+			throw;
+		}
+		_index.insert(h, _groups.size() - 1);
+	}
+
+	void erase(const T *v){
+
+		const K &key = v->*_member;
+		std::size_t h = _hash(key);
+		std::size_t g = search(key, h);
+
+		std::vector<const T *> &m = _groups[g].members;
+		m.erase(std::find(m.begin(), m.end(), v));
+		if(!m.empty())
+			return;
+
+		//il gruppo vuoto viene sostituito dall'ultimo
+		_index.erase(h, g);
+		std::size_t last = _groups.size() - 1;
+		if(g != last){
+			_index.erase(_groups[last].hash, last);
+			_groups[g] = std::move(_groups[last]);
+			_index.insert(_groups[g].hash, g);
+		}
+		_groups.pop_back();
+	}
+
+	void clear(void){
+		_groups.clear();
+		_index.clear();
+	}
+};
+
+} // namespace set_detail
+
+/**
+	@brief Set con indici secondari sui campi degli elementi
+
+	Classe che rappresenta un set di elementi di tipo struttura (es. voce) a cui
+	possono essere associati indici secondari su singoli campi (es. &voce::cognome).
+	Gli indici vengono aggiornati da ogni aggiunta e rimozione, e permettono di
+	ottenere con equal_range tutti gli elementi con un dato valore del campo senza
+	scandire il set e senza copiare gli elementi.
+	Gli elementi sono memorizzati in un set con list_storage, che non li sposta mai
+	in memoria: gli indici possono quindi riferirli tramite puntatori.
+	Gli iteratori restituiti da equal_range restano validi fino alla successiva
+	aggiunta o rimozione.
+	@param T Tipo degli elementi.
+	@param Eql Funtore per l'uguaglianza tra elementi.
+	@param Hash Funtore di hash, oppure no_hash.
+	@param Alloc Allocatore dei nodi.
+**/
+template <typename T, typename Eql = std::equal_to<T>, typename Hash = no_hash, typename Alloc = std::allocator<T> >
+class indexed_set{
+
+public:
+	typedef set<T, Eql, Hash, list_storage, Alloc> set_type;	///< Set che contiene gli elementi
+	typedef std::size_t size_type;	///< Definzione del tipo corrispondente a size
+	typedef typename set_type::const_iterator const_iterator;	///< Iteratore sugli elementi
+
+	/**
+		@brief Riferimento ad un indice secondario
+
+		Restituito da add_index e usato da equal_range. Il tipo ricorda il tipo
+		del campo e i suoi funtori, la posizione e l'identificativo individuano
+		l'indice. Resta valido anche per le copie del set; usato con un altro set
+		fa lanciare std::invalid_argument.
+	**/
+	template <typename K, typename KHash, typename KEql>
+	class key_index{
+		std::size_t _position;	///< Posizione dell'indice nel set
+		std::size_t _id;	///< Identificativo dell'indice
+
+		friend class indexed_set;
+		key_index(std::size_t position, std::size_t id) : _position(position), _id(id) {}
+
+	public:
+		typedef K key_type;	///< Tipo del campo indicizzato
+	};
+
+	/**
+		@brief Definizione della classe match_iterator
+
+		Iteratore costante sugli elementi restituiti da equal_range,
+		nell'ordine di inserimento.
+	**/
+	class match_iterator{
+		const T * const *p;
+
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef T                         value_type;
+		typedef ptrdiff_t                 difference_type;
+		typedef const T*                  pointer;
+		typedef const T&                  reference;
+
+		/**
+			@brief Costruttore di default
+
+			Costruttore di default per istanziare un match_iterator.
+		**/
+		match_iterator() : p(0) {}
+
+		/**
+			@brief Operatore di dereferenziamento
+
+			@return Il riferimento costante all'elemento.
+		**/
+		reference operator*() const {
+			return **p;
+		}
+
+		/**
+			@brief Operatore freccia
+
+			@return Il puntatore costante all'elemento.
+		**/
+		pointer operator->() const {
+			return *p;
+		}
+
+		/**
+			@brief Operatore di iterazione post-incremento
+
+			@return La copia del match_iterator non iterata.
+		**/
+		match_iterator operator++(int) {
+			match_iterator tmp(*this);
+			++p;
+			return tmp;
+		}
+
+		/**
+			@brief Operatore di iterazione pre-incremento
+
+			@return Il riferimento al match_iterator.
+		**/
+		match_iterator& operator++() {
+			++p;
+			return *this;
+		}
+
+		/**
+			@brief Operatore di uguaglianza
+
+			@param other Il match_iterator con cui effettuare la comparazione.
+			@return true se i due iteratori riferiscono lo stesso elemento.
+		**/
+		bool operator==(const match_iterator &other) const {
+			return p == other.p;
+		}
+
+		/**
+			@brief Operatore di diversità
+
+			@param other Il match_iterator con cui effettuare la comparazione.
+			@return true se i due iteratori riferiscono elementi diversi.
+		**/
+		bool operator!=(const match_iterator &other) const {
+			return p != other.p;
+		}
+
+	private:
+		friend class indexed_set;
+		explicit match_iterator(const T * const *pp) : p(pp) {}
+	};
+
+	typedef std::pair<match_iterator, match_iterator> match_range;	///< Intervallo restituito da equal_range
+
+private:
+	typedef set_detail::secondary_index_base<T> index_base;
+
+	set_type _set;	///< Elementi
+	std::vector<std::unique_ptr<index_base> > _indexes;	///< Indici secondari, nell'ordine di add_index
+
+	/**
+		@brief Aggiunge un elemento a tutti gli indici
+
+		In caso di eccezione l'elemento viene rimosso dagli indici già aggiornati.
+		@param v Puntatore all'elemento.
+	**/
+	void index_value(const T *v){
+
+		std::size_t i = 0;
+		try{
+			for(; i < _indexes.size(); ++i)
+				_indexes[i]->insert(v);
+		}catch(...){
+			while(i-- > 0)
+				_indexes[i]->erase(v);
+			throw;
+		}
+	}
+
+	/**
+		@brief Rimuove un elemento da tutti gli indici
+
+		@param v Puntatore all'elemento.
+	**/
+	void unindex_value(const T *v){
+		for(std::size_t i = 0; i < _indexes.size(); ++i)
+			_indexes[i]->erase(v);
+	}
+
+	/**
+		@brief Indice secondario riferito da un key_index
+
+		@param index Indice restituito da add_index.
+		@return L'indice secondario.
+		@throw std::invalid_argument Se index non appartiene a questo set o alle sue copie.
+	**/
+	template <typename K, typename KHash, typename KEql>
+	const set_detail::secondary_index<T, K, KHash, KEql> &lookup(const key_index<K, KHash, KEql> &index) const{
+
+		if(index._position >= _indexes.size() || _indexes[index._position]->id() != index._id)
+			throw std::invalid_argument("indexed_set: key_index of another set");
+		return static_cast<const set_detail::secondary_index<T, K, KHash, KEql> &>(*_indexes[index._position]);
+	}
+
+	/**
+		@brief Indicizza l'ultimo elemento aggiunto al set
+
+		Se l'aggiornamento degli indici fallisce l'elemento viene rimosso dal set.
+	**/
+	void index_back(void){
+		try{
+			index_value(&set_detail::set_access::back(_set));
+		}catch(...){
+			set_detail::set_access::pop_back(_set);
+			throw;
+		}
+	}
+
+public:
+	/**
+		@brief Costruttore di default
+
+		Costruttore di default per istanziare un set vuoto senza indici.
+	**/
+	indexed_set() {}
+
+	/**
+		@brief Costruttore secondario (COSTRUTTORE DI COPIA)
+
+		Copia gli elementi e ricostruisce sulla copia gli stessi indici.
+		@param other Set sorgente.
+	**/
+	indexed_set(const indexed_set &other) : _set(other._set) {
+
+		_indexes.reserve(other._indexes.size());
+		for(std::size_t i = 0; i < other._indexes.size(); ++i){
+			_indexes.emplace_back(other._indexes[i]->clone_empty());
+			for(const_iterator e = _set.begin(), ee = _set.end(); e != ee; ++e)
+				_indexes[i]->insert(&*e);
+		}
+	}
+
+	/**
+		@brief Costruttore secondario (COSTRUTTORE DI SPOSTAMENTO)
+
+		Gli elementi non vengono spostati in memoria, quindi gli indici
+		passano al nuovo set senza essere ricostruiti.
+		@param other Set sorgente, che rimane vuoto e senza indici.
+	**/
+	indexed_set(indexed_set &&other) {
+		swap(other);
+	}
+
+	/**
+		@brief Operatore di assegnamento
+
+		@param other Set sorgente.
+		@return Il riferimento al set.
+	**/
+	indexed_set &operator=(const indexed_set &other){
+		if(this != &other){
+			indexed_set tmp(other);
+			swap(tmp);
+		}
+		return *this;
+	}
+
+	/**
+		@brief Operatore di assegnamento per spostamento
+
+		@param other Set sorgente.
+		@return Il riferimento al set.
+	**/
+	indexed_set &operator=(indexed_set &&other){
+		swap(other);
+		return *this;
+	}
+
+	/**
+		@brief Scambia il contenuto di due set, indici compresi
+
+		@param other Set con cui scambiare il contenuto.
+	**/
+	void swap(indexed_set &other){
+		_set.swap(other._set);
+		_indexes.swap(other._indexes);
+	}
+
+	/**
+		@brief Aggiunge un indice secondario su un campo
+
+		L'indice viene costruito sugli elementi già presenti.
+		@param member Campo da indicizzare, es. &voce::cognome.
+		@return Il riferimento all'indice da passare a equal_range.
+	**/
+	template <typename K, typename KHash = std::hash<K>, typename KEql = std::equal_to<K> >
+	key_index<K, KHash, KEql> add_index(K T::*member){
+
+		std::size_t id = set_detail::next_index_id();
+		std::unique_ptr<index_base> index(new set_detail::secondary_index<T, K, KHash, KEql>(member, id));
+		for(const_iterator i = _set.begin(), ie = _set.end(); i != ie; ++i)
+			index->insert(&*i);
+		_indexes.push_back(std::move(index));
+		return key_index<K, KHash, KEql>(_indexes.size() - 1, id);
+	}
+
+	/**
+		@brief Elementi con un valore del campo indicizzato
+
+		@param index Indice restituito da add_index.
+		@param key Valore del campo da cercare.
+		@return L'intervallo degli elementi il cui campo è uguale a key,
+		nell'ordine di inserimento.
+		@throw std::invalid_argument Se index non appartiene a questo set o alle sue copie.
+	**/
+	template <typename K, typename KHash, typename KEql>
+	match_range equal_range(const key_index<K, KHash, KEql> &index, const typename key_index<K, KHash, KEql>::key_type &key) const{
+
+		std::pair<const T * const *, const T * const *> r = lookup(index).equal_range(key);
+		return match_range(match_iterator(r.first), match_iterator(r.second));
+	}
+
+	/**
+		@brief Numero di elementi con un valore del campo indicizzato
+
+		@param index Indice restituito da add_index.
+		@param key Valore del campo da cercare.
+		@return Il numero di elementi il cui campo è uguale a key.
+		@throw std::invalid_argument Se index non appartiene a questo set o alle sue copie.
+	**/
+	template <typename K, typename KHash, typename KEql>
+	size_type count(const key_index<K, KHash, KEql> &index, const typename key_index<K, KHash, KEql>::key_type &key) const{
+		match_range r = equal_range(index, key);
+		return static_cast<size_type>(std::distance(r.first, r.second));
+	}
+
+	/**
+		@brief Aggiunge un elemento al set
+
+		@param value Il valore da aggiungere al set.
+		@throw already_existing_exception Eccezione che viene lanciata
+		in caso di elemento già esistente nel set.
+	**/
+	void add(const T &value){
+		if(!try_add(value))
+			throw already_existing_exception();
+	}
+
+	/**
+		@brief Aggiunge un elemento al set per spostamento
+
+		@param value Il valore da spostare nel set.
+		@throw already_existing_exception Eccezione che viene lanciata
+		in caso di elemento già esistente nel set.
+	**/
+	void add(T &&value){
+		if(!try_add(std::move(value)))
+			throw already_existing_exception();
+	}
+
+	/**
+		@brief Aggiunge un elemento al set, se non esistente
+
+		@param value Il valore da aggiungere al set.
+		@return true se l'elemento è stato aggiunto, false se era già esistente.
+	**/
+	bool try_add(const T &value){
+		if(!_set.try_add(value))
+			return false;
+		index_back();
+		return true;
+	}
+
+	/**
+		@brief Aggiunge un elemento al set per spostamento, se non esistente
+
+		@param value Il valore da spostare nel set.
+		@return true se l'elemento è stato aggiunto, false se era già esistente.
+	**/
+	bool try_add(T &&value){
+		if(!_set.try_add(std::move(value)))
+			return false;
+		index_back();
+		return true;
+	}
+
+	/**
+		@brief Rimuove un elemento dal set
+
+		@param value Il valore da rimuovere dal set.
+		@throw not_existing_exception Eccezione che viene lanciata
+		in caso di elemento non esistente nel set.
+	**/
+	void remove(const T &value){
+		if(!try_remove(value))
+			throw not_existing_exception();
+	}
+
+	/**
+		@brief Rimuove un elemento dal set, se esistente
+
+		@param value Il valore da rimuovere dal set.
+		@return true se l'elemento è stato rimosso, false se non era presente.
+	**/
+	bool try_remove(const T &value){
+
+		const_iterator i = _set.find(value);
+		if(i == _set.end())
+			return false;
+		unindex_value(&*i);
+		return _set.try_remove(value);
+	}
+
+	/**
+		@brief Rimuove dal set gli elementi che soddisfano un predicato
+
+		@param P Predicato applicato agli elementi del set.
+		@return Il numero di elementi rimossi.
+	**/
+	template <typename Pred>
+	size_type erase_if(Pred P){
+		return _set.erase_if([&](const T &v){
+			if(!P(v))
+				return false;
+			unindex_value(&v);
+			return true;
+		});
+	}
+
+	/**
+		@brief Svuota il set
+
+		Elimina tutti gli elementi; gli indici restano definiti, vuoti.
+	**/
+	void clear_set(void){
+		_set.clear_set();
+		for(std::size_t i = 0; i < _indexes.size(); ++i)
+			_indexes[i]->clear();
+	}
+
+	/**
+		@brief Verifica la presenza di un elemento
+
+		@param value Il valore da cercare.
+		@return true se l'elemento è presente nel set.
+	**/
+	bool contains(const T &value) const{
+		return _set.contains(value);
+	}
+
+	/**
+		@brief Accesso ai dati in sola lettura
+
+		@pre E' necessario che index < size.
+		@param index Indice dell'elemento nel set da leggere.
+		@return Il riferimento costante all'elemento.
+	**/
+	const T &operator[](size_type index) const{
+		return _set[index];
+	}
+
+	/**
+		@brief Dimensione del set
+
+		@return Il numero di elementi contenuti nel set.
+	**/
+	size_type size(void) const{
+		return _set.size();
+	}
+
+	/**
+		@brief Elementi del set
+
+		@return Il riferimento costante al set che contiene gli elementi,
+		da usare con le funzioni globali (es. filter_out).
+	**/
+	const set_type &elements(void) const{
+		return _set;
+	}
+
+	/**
+		@brief Iteratore all'inizio della sequenza di dati
+
+		@return L'iteratore all'inizio della sequenza di dati.
+	**/
+	const_iterator begin() const {
+		return _set.begin();
+	}
+
+	/**
+		@brief Iteratore alla fine della sequenza di dati
+
+		@return L'iteratore alla fine della sequenza di dati.
+	**/
+	const_iterator end() const {
+		return _set.end();
+	}
+};
+
+/**
+	@brief Operatore di stream
+
+	Permette di spedire su uno stream di output il contenuto dell'indexed_set.
+	@param os stream di output
+	@param data_set Set sorgente i cui elementi verranno spediti sullo stream.
+	@return Il riferimento allo stream di output.
+**/
+template <typename T, typename... P>
+std::ostream &operator<<(std::ostream &os, const indexed_set<T, P...> &data_set){
+	return os << data_set.elements();
+}
+
+#endif
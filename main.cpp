@@ -1,7 +1,27 @@
 #include "set.h"
+#include "node_pool.h"
+#include "concurrent_set.h"
+#include "frozen_set.h"
+#include "ordered_set.h"
+#include "set_io.h"
+#include "fixed_set.h"
+#include "string_set.h"
+#include "indexed_set.h"
 #include <iostream>
+#include <sstream>
 #include <cassert>
 #include <string>
+#include <functional>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <thread>
+#include <type_traits>
+#include <cstdio>
+#include <string_view>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
 
 /**
 	@brief Definizione del funtore per l'uguaglianza tra interi
@@ -121,6 +141,23 @@ struct equal_voce{
 	}		
 };
 
+/**
+	@brief Definizione del funtore di hash per le voci
+
+	Funtore che calcola l'hash di una voce combinando gli hash dei suoi attributi,
+	coerentemente con il criterio di uguaglianza di equal_voce.
+**/
+struct hash_voce{
+
+	std::size_t operator()(const voce &v) const {
+		std::hash<std::string> h;
+		std::size_t seed = h(v.ntel);
+		seed ^= h(v.nome) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+		seed ^= h(v.cognome) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+		return seed;
+	}
+};
+
 /**
 	@brief Definizione del funtore per il controllo del cognome di una voce
 
@@ -135,6 +172,142 @@ struct voce_surname_Rossi{
 	}
 };
 
+/**
+	@brief Definizione del funtore per l'uguaglianza tra voci per numero di telefono
+
+	Funtore trasparente: confronta una voce con un'altra voce oppure
+	direttamente con un numero di telefono.
+**/
+struct equal_voce_ntel{
+	typedef void is_transparent;
+
+	bool operator()(const voce &a, const voce &b) const {
+		return a.ntel == b.ntel;
+	}
+
+	bool operator()(const voce &a, const std::string &ntel) const {
+		return a.ntel == ntel;
+	}
+};
+
+/**
+	@brief Definizione del funtore di hash per le voci per numero di telefono
+
+	Funtore trasparente coerente con equal_voce_ntel.
+**/
+struct hash_voce_ntel{
+	typedef void is_transparent;
+
+	std::size_t operator()(const voce &v) const {
+		return std::hash<std::string>()(v.ntel);
+	}
+
+	std::size_t operator()(const std::string &ntel) const {
+		return std::hash<std::string>()(ntel);
+	}
+};
+
+/**
+	@brief Codifica binaria di una voce
+
+	Specializzazione di element_codec che scrive i tre campi
+	della voce, ciascuno preceduto dalla sua lunghezza.
+**/
+template <>
+struct element_codec<voce>{
+
+	static void encode(std::string &out, const voce &v){
+		codec_put(out, v.nome);
+		codec_put(out, v.cognome);
+		codec_put(out, v.ntel);
+	}
+
+	static voce decode(const char *data, std::size_t size){
+		codec_reader r(data, size);
+		std::string nome = r.get_string();
+		std::string cognome = r.get_string();
+		std::string ntel = r.get_string();
+		return voce(nome, cognome, ntel);
+	}
+};
+
+/**
+	@brief Definizione di un tipo che conta le proprie copie
+
+	Struttura usata per verificare che il set non copi gli elementi
+	quando vengono spostati o costruiti sul posto.
+**/
+struct tracked{
+	static int copies;	///< Numero di copie effettuate
+	int id;
+
+	tracked(int i) : id(i) {}
+	tracked(const tracked &other) : id(other.id) { copies++; }
+	tracked(tracked &&other) noexcept : id(other.id) {}
+};
+
+int tracked::copies = 0;
+
+/**
+	@brief Definizione del funtore per l'uguaglianza tra tracked
+
+	Funtore che confronta due tracked tramite il loro identificativo.
+**/
+struct equal_tracked{
+
+	bool operator()(const tracked &a, const tracked &b) const {
+		return a.id == b.id;
+	}
+};
+
+/**
+	@brief Definizione del funtore per l'uguaglianza tra interi con conteggio
+
+	Funtore equivalente a equal_int che conta i confronti effettuati.
+**/
+struct counting_equal_int{
+	static long long comparisons;	///< Numero di confronti effettuati
+
+	bool operator()(const int a, const int b) const {
+		comparisons++;
+		return a == b;
+	}
+};
+
+long long counting_equal_int::comparisons = 0;
+
+/**
+	@brief Allocatore che conta le allocazioni
+
+	Allocatore equivalente a std::allocator che conta le chiamate ad allocate.
+**/
+template <typename T>
+struct counting_allocator{
+	typedef T value_type;
+
+	counting_allocator() {}
+
+	template <typename U>
+	counting_allocator(const counting_allocator<U> &) {}
+
+	T *allocate(std::size_t n){
+		allocations()++;
+		return std::allocator<T>().allocate(n);
+	}
+
+	void deallocate(T *p, std::size_t n){
+		std::allocator<T>().deallocate(p, n);
+	}
+
+	static long long &allocations(void){
+		static long long count = 0;
+		return count;
+	}
+
+	bool operator==(const counting_allocator &) const { return true; }
+	bool operator!=(const counting_allocator &) const { return false; }
+};
+
 void test_int(){
 	typedef set<int, equal_int> set_int_type;
 	set_int_type set1;			//default constructor
@@ -357,10 +530,1354 @@ void test_voce(){
 	std::cout << "---------------------" << std::endl;
 }
 
+void test_hash(){
+	typedef set<int, equal_int, std::hash<int> > set_hash_type;
+	set_hash_type set1;
+
+	for(int k = 0; k < 20000; ++k)	//add() con indice hash
+		set1.add(k * 1024);
+	assert(set1.size() == 20000);
+
+	try{
+		set1.add(5 * 1024);		//already_existing_exception
+		assert(false);
+	}catch(already_existing_exception){}
+
+	for(int k = 0; k < 20000; k += 2)	//remove() con indice hash
+		set1.remove(k * 1024);
+	assert(set1.size() == 10000);
+
+	try{
+		set1.remove(0);		//not_existing_exception
+		assert(false);
+	}catch(not_existing_exception){}
+
+	assert(set1[0] == 1024);	//ordine di inserimento
+	assert(set1[9999] == 19999 * 1024);
+
+	set1.add(0);			//reinserimento in coda
+	assert(set1[10000] == 0);
+
+	set_hash_type set2;
+	set2 = set1;			//operator=
+	set2.remove(0);
+	assert(set2.size() == 10000);
+	set1.clear_set();
+	set1.add(0);
+	assert(set1.size() == 1);
+
+	set_hash_type filtered = filter_out(set2, is_odd());	//filter_out
+	assert(filtered.size() == 10000);
+
+	typedef set<voce, equal_voce, hash_voce> set_voce_hash_type;
+	set_voce_hash_type set3;
+	set3.add(voce("Mario", "Rossi", "6959595"));
+	set3.add(voce("Luca", "Rossi", "8855855"));
+	set3.add(voce("Sara", "Verdi", "987654"));
+
+	try{
+		set3.add(voce("Luca", "Rossi", "8855855"));	//already_existing_exception
+		assert(false);
+	}catch(already_existing_exception){}
+
+	set3.remove(voce("Mario", "Rossi", "6959595"));
+	assert(set3.size() == 2);
+	assert(set3[0] == voce("Luca", "Rossi", "8855855"));
+
+	std::cout << "test_hash() OK" << std::endl;
+	std::cout << "---------------------" << std::endl;
+}
+
+void test_vector_storage(){
+	typedef set<int, equal_int, std::hash<int>, vector_storage> set_vector_type;
+	set_vector_type set1;
+
+	for(int k = 0; k < 1000; ++k)	//add() su array contiguo
+		set1.add(k);
+
+	for(int k = 0; k < 1000; ++k)	//lapidi e compattazione
+		if(k % 3 != 0)
+			set1.remove(k);
+	assert(set1.size() == 334);
+
+	int expected = 0;		//ordine di inserimento dopo la compattazione
+	for(set_vector_type::const_iterator i = set1.begin(); i != set1.end(); ++i, expected += 3)
+		assert(*i == expected);
+
+	try{
+		set1.add(999);		//already_existing_exception dopo la compattazione
+		assert(false);
+	}catch(already_existing_exception){}
+
+	set1.remove(999);		//rimozione in coda
+	set1.add(1);
+	assert(set1[333] == 1);
+
+	typedef set<voce, equal_voce, no_hash, vector_storage> set_voce_vector_type;
+	set_voce_vector_type set2;
+	set2.add(voce("Mario", "Rossi", "6959595"));
+	set2.add(voce("Luca", "Rossi", "8855855"));
+	set2.add(voce("Sara", "Verdi", "987654"));
+	set2.remove(voce("Mario", "Rossi", "6959595"));	//head deletion
+
+	set_voce_vector_type filtered = filter_out(set2, voce_surname_Rossi());
+	assert(filtered.size() == 1);
+	assert(filtered[0] == voce("Sara", "Verdi", "987654"));
+
+	try{
+		set_voce_vector_type concat;
+		concat = set2 + filtered;		//operator+ con intersezione non vuota
+		assert(false);
+	}catch(already_existing_exception){}
+
+	std::cout << "test_vector_storage() OK" << std::endl;
+	std::cout << "---------------------" << std::endl;
+}
+
+void test_operator_index(){
+	typedef set<int, equal_int, std::hash<int> > set_list_type;
+	typedef set<int, equal_int, std::hash<int>, vector_storage> set_vector_type;
+	set_list_type set1;
+	set_vector_type set2;
+
+	for(int k = 0; k < 100000; ++k){
+		set1.add(k);
+		set2.add(k);
+	}
+
+	long long sum = 0;
+	for(unsigned int k = 0; k < set1.size(); ++k)	//operator[] in tempo costante
+		sum += set1[k] + set2[k];
+	assert(sum == 2 * (99999LL * 100000 / 2));
+
+	set1.add(-1);			//add() aggiorna la tabella delle posizioni
+	assert(set1[100000] == -1);
+
+	set1.remove(10);		//gli indici successivi scalano di una posizione
+	set2.remove(10);
+	assert(set1[9] == 9 && set1[10] == 11);
+	assert(set2[9] == 9 && set2[10] == 11);	//accesso con lapidi
+	assert(set1[99999] == -1);
+	assert(set2[99998] == 99999);
+
+	for(int k = 20; k < 30; ++k){	//remove() toglie una sola posizione dalla tabella
+		set1.remove(k);
+		set2.remove(k);
+		assert(set1[19] == k + 1 && set2[19] == k + 1);
+	}
+
+	const set_list_type set3(set1);	//costruzione della tabella da più thread
+	std::vector<std::thread> readers;
+	std::vector<long long> sums(4, 0);
+	for(int t = 0; t < 4; ++t){
+		readers.push_back(std::thread([&set3, &sums, t](){
+			for(unsigned int k = 0; k < set3.size(); ++k)
+				sums[t] += set3[k];
+		}));
+	}
+	for(std::size_t t = 0; t < readers.size(); ++t)
+		readers[t].join();
+	for(std::size_t t = 1; t < sums.size(); ++t)
+		assert(sums[t] == sums[0]);
+
+	set1.clear_set();
+	set1.add(7);
+	assert(set1[0] == 7);
+
+	std::cout << "test_operator_index() OK" << std::endl;
+	std::cout << "---------------------" << std::endl;
+}
+
+void test_node_pool(){
+	typedef set<int, equal_int, std::hash<int>, list_storage, node_pool_allocator<int> > set_pool_type;
+	set_pool_type set1;
+
+	for(int k = 0; k < 5000; ++k)		//nodi ritagliati dalle slab
+		set1.add(k);
+	for(int k = 0; k < 5000; k += 2)	//nodi restituiti alla free list
+		set1.remove(k);
+	for(int k = 0; k < 5000; k += 2)	//nodi riciclati dalla free list
+		set1.add(-k);
+	assert(set1.size() == 5000);
+	assert(set1[0] == 1 && set1[2500] == 0);
+
+	set_pool_type set2;
+	set2 = set1;			//operator=, pool distinto
+	set1.clear_set();		//rilascio in blocco
+	assert(set1.size() == 0);
+	set1.add(3);
+	assert(set1[0] == 3);
+	assert(set2.size() == 5000 && set2[4999] == -4998);
+
+	typedef set<voce, equal_voce, hash_voce, list_storage, node_pool_allocator<voce> > set_voce_pool_type;
+	set_voce_pool_type set3;
+	set3.add(voce("Mario", "Rossi", "6959595"));
+	set3.add(voce("Luca", "Rossi", "8855855"));
+	set3.add(voce("Sara", "Verdi", "987654"));
+	set3.remove(voce("Luca", "Rossi", "8855855"));
+
+	set_voce_pool_type filtered = filter_out(set3, voce_surname_Rossi());
+	assert(filtered.size() == 1);
+	assert(filtered[0] == voce("Sara", "Verdi", "987654"));
+
+	node_pool_allocator<int> alloc1;	//le conversioni condividono il gruppo di pool
+	node_pool_allocator<voce> alloc2(alloc1);
+	assert(node_pool_allocator<int>(alloc2) == alloc1 && alloc2 == alloc1);
+	assert(!(node_pool_allocator<int>() == alloc1));
+	voce *v = alloc2.allocate(1);
+	node_pool_allocator<voce>(node_pool_allocator<double>(alloc1)).deallocate(v, 1);
+	assert(alloc2.allocate(1) == v);	//blocco riciclato dalla free list condivisa
+	alloc2.deallocate(v, 1);
+
+	std::cout << "test_node_pool() OK" << std::endl;
+	std::cout << "---------------------" << std::endl;
+}
+
+void test_move(){
+	typedef set<tracked, equal_tracked> set_tracked_type;
+	set_tracked_type set1;
+	tracked::copies = 0;
+
+	set1.emplace(1);			//emplace()
+	set1.add(tracked(2));		//add(T&&)
+	tracked t(3);
+	set1.add(std::move(t));
+	try{
+		set1.emplace(2);		//already_existing_exception
+		assert(false);
+	}catch(already_existing_exception){}
+	assert(set1.size() == 3);
+
+	set_tracked_type set2(std::move(set1));	//costruttore di spostamento
+	assert(set2.size() == 3 && set1.size() == 0);
+	set1 = std::move(set2);				//assegnamento per spostamento
+	assert(set1.size() == 3 && set2.size() == 0);
+	assert(set1[2].id == 3);
+	assert(tracked::copies == 0);
+
+	set2.emplace(4);			//il set sorgente resta utilizzabile
+	assert(set2.size() == 1);
+
+	typedef set<voce, equal_voce, hash_voce, vector_storage> set_voce_type;
+	set_voce_type set3;
+	set3.emplace("Mario", "Rossi", "6959595");
+	set3.add(voce("Luca", "Rossi", "8855855"));
+	try{
+		set3.emplace("Mario", "Rossi", "6959595");	//already_existing_exception
+		assert(false);
+	}catch(already_existing_exception){}
+	set_voce_type filtered = filter_out(set3, voce_surname_Rossi());
+	assert(filtered.size() == 0);
+	assert(set3[0] == voce("Mario", "Rossi", "6959595"));
+
+	static_assert(std::is_nothrow_move_constructible<set<voce, equal_voce> >::value, "spostamento noexcept");
+	static_assert(std::is_nothrow_move_assignable<set_voce_type>::value, "assegnamento noexcept");
+	std::vector<set_tracked_type> sets;	//la riallocazione sposta i set senza copiarne gli elementi
+	for(int k = 0; k < 10; ++k){
+		sets.push_back(set_tracked_type());
+		sets.back().emplace(k);
+	}
+	assert(sets.size() == 10 && sets[9][0].id == 9 && tracked::copies == 0);
+
+	std::cout << "test_move() OK" << std::endl;
+	std::cout << "---------------------" << std::endl;
+}
+
+void test_copy(){
+	typedef set<int, counting_equal_int> set_list_type;
+	typedef set<int, counting_equal_int, std::hash<int>, vector_storage> set_vector_type;
+	set_list_type set1;
+	set_vector_type set2;
+
+	for(int k = 0; k < 2000; ++k){
+		set1.add(k);
+		set2.add(k);
+	}
+	set2.remove(0);				//array con lapidi
+
+	counting_equal_int::comparisons = 0;
+	set_list_type copy1(set1);		//copia in O(N), senza confronti
+	set_vector_type copy2(set2);
+	assert(counting_equal_int::comparisons == 0);
+	assert(copy1.size() == 2000 && copy1[1999] == 1999);
+	assert(copy2.size() == 1999 && copy2[0] == 1);
+
+	set_list_type small;
+	small.add(-1);
+	small.add(-2);
+	set_list_type two;
+	two.add(42);
+	two.add(43);
+
+	counting_equal_int::comparisons = 0;
+	small = set1;				//riutilizzo dei nodi e aggiunta in coda
+	assert(small.size() == 2000 && small[0] == 0 && small[1999] == 1999);
+	small = two;				//rimozione dei nodi in eccesso
+	assert(small.size() == 2 && small[1] == 43);
+	assert(counting_equal_int::comparisons == 0);
+
+	copy2 = set_vector_type();
+	copy2 = set2;				//indice copiato da un array con lapidi
+	try{
+		copy2.add(1999);		//already_existing_exception
+		assert(false);
+	}catch(already_existing_exception){}
+
+	std::cout << "test_copy() OK" << std::endl;
+	std::cout << "---------------------" << std::endl;
+}
+
+void test_try(){
+	typedef set<std::string, equal_string, std::hash<std::string> > set_string_type;
+	set_string_type set1;
+
+	assert(set1.try_add("Mario"));		//try_add()
+	assert(set1.try_add(std::string("Luca")));
+	assert(!set1.try_add("Mario"));		//duplicato, nessuna eccezione
+	assert(set1.size() == 2);
+
+	assert(set1.try_remove("Mario"));	//try_remove()
+	assert(!set1.try_remove("Mario"));	//non esistente, nessuna eccezione
+	assert(set1.size() == 1 && set1[0] == "Luca");
+
+	set_string_type set2;
+	set2.add("Sara");
+	set2.add("Luca");
+	try{
+		set_string_type concat = set1 + set2;	//operator+ con intersezione non vuota
+		assert(false);
+	}catch(already_existing_exception){}
+
+	set2.remove("Luca");
+	set_string_type concat = set1 + set2;
+	assert(concat.size() == 2 && concat[1] == "Sara");
+
+	std::cout << "test_try() OK" << std::endl;
+	std::cout << "---------------------" << std::endl;
+}
+
+void test_algebra(){
+	typedef set<int, equal_int, std::hash<int> > set_hash_type;
+	typedef set<int, equal_int, std::hash<int>, vector_storage> set_vector_type;
+	typedef set<std::string, equal_string> set_string_type;
+
+	set_hash_type a, b;
+	set_vector_type va, vb;
+	for(int k = 0; k < 100; ++k){
+		a.add(k);			//0..99
+		b.add(k + 50);			//50..149
+		va.add(k);
+		vb.add(k + 50);
+	}
+
+	set_hash_type u = set_union(a, b);	//set_union
+	assert(u.size() == 150 && u[0] == 0 && u[149] == 149);
+
+	set_hash_type i = set_intersection(a, b);	//set_intersection
+	assert(i.size() == 50 && i[0] == 50 && i[49] == 99);
+
+	set_hash_type d = set_difference(a, b);		//set_difference
+	assert(d.size() == 50 && d[0] == 0 && d[49] == 49);
+
+	set_hash_type x = set_symmetric_difference(a, b);	//set_symmetric_difference
+	assert(x.size() == 100 && x[49] == 49 && x[50] == 100);
+
+	va &= vb;					//operator&= con compattazione
+	assert(va.size() == 50 && va[0] == 50);
+	try{
+		va.add(99);			//already_existing_exception
+		assert(false);
+	}catch(already_existing_exception){}
+	va |= vb;					//operator|=
+	assert(va.size() == 100 && va[99] == 149);
+	va -= vb;					//operator-=
+	assert(va.size() == 0);
+	va ^= vb;					//operator^=
+	assert(va.size() == 100);
+	va ^= va;
+	assert(va.size() == 0);
+
+	set_string_type s1, s2;		//senza indice hash
+	s1.add("Mario");
+	s1.add("Luca");
+	s2.add("Luca");
+	s2.add("Sara");
+	assert(set_union(s1, s2).size() == 3);
+	assert(set_intersection(s1, s2)[0] == "Luca");
+	assert(set_difference(s2, s1)[0] == "Sara");
+	s1 -= s2;
+	assert(s1.size() == 1 && s1[0] == "Mario");
+
+	std::cout << "test_algebra() OK" << std::endl;
+	std::cout << "---------------------" << std::endl;
+}
+
+void test_bulk(){
+	typedef set<int, equal_int, std::hash<int> > set_hash_type;
+	typedef set<std::string, equal_string, std::hash<std::string>, vector_storage> set_vector_type;
+
+	std::vector<int> batch;
+	for(int k = 0; k < 10000; ++k)
+		batch.push_back(k % 7000);	//3000 duplicati interni al lotto
+
+	set_hash_type set1;
+	set1.add(-1);
+	set1.add(5);
+	try{
+		set1.add_bulk(batch.begin(), batch.end());	//duplicates_throw
+		assert(false);
+	}catch(already_existing_exception){}
+	assert(set1.size() == 2 && set1[1] == 5);	//nessun elemento aggiunto
+
+	assert(set1.add_bulk(batch.begin(), batch.end(), duplicates_skip) == 6999);
+	assert(set1.size() == 7001 && set1[2] == 0 && set1[7000] == 6999);
+
+	std::vector<int> rejected;		//segnalazione dei duplicati
+	int more[] = {5, 7000, 7001, 7000};
+	assert(set1.add_bulk(more, more + 4, std::back_inserter(rejected)) == 2);
+	assert(rejected.size() == 2 && rejected[0] == 5 && rejected[1] == 7000);
+
+	const char *names[] = {"Mario", "Luca", "Sara"};
+	set_vector_type set2(names, names + 3);		//set(Q b, Q e)
+	assert(set2.size() == 3 && set2[2] == "Sara");
+	const char *dup[] = {"Giovanni", "Luca"};
+	assert(set2.add_bulk(dup, dup + 2, duplicates_skip) == 1);
+	assert(set2[3] == "Giovanni");
+
+	std::cout << "test_bulk() OK" << std::endl;
+	std::cout << "---------------------" << std::endl;
+}
+
+void test_parallel_filter(){
+	typedef set<int, equal_int, std::hash<int> > set_hash_type;
+	typedef set<voce, equal_voce, no_hash, vector_storage> set_voce_type;
+
+	set_hash_type set1;
+	for(int k = 0; k < 100000; ++k)
+		set1.add(k * 3);
+
+	set_hash_type serial = filter_out(set1, is_odd());
+	set_hash_type parallel = filter_out(set1, is_odd(), 4);	//filter_out parallelo
+	assert(serial.size() == 50000 && parallel.size() == 50000);
+	for(unsigned int k = 0; k < parallel.size(); ++k)	//ordine originale
+		assert(parallel[k] == serial[k]);
+	try{
+		parallel.add(6);		//indice hash costruito dai thread
+		assert(false);
+	}catch(already_existing_exception){}
+
+	set_hash_type empty;
+	assert(filter_out(empty, is_odd(), 0).size() == 0);
+
+	set_voce_type set2;
+	set2.add(voce("Mario", "Rossi", "6959595"));
+	set2.add(voce("Sara", "Verdi", "987654"));
+	set2.add(voce("Luca", "Rossi", "8855855"));
+	set2.add(voce("Deborah", "Verdi", "2548963"));
+	set_voce_type filtered = filter_out(set2, voce_surname_Rossi(), 3);
+	assert(filtered.size() == 2);
+	assert(filtered[0] == voce("Sara", "Verdi", "987654"));
+	assert(filtered[1] == voce("Deborah", "Verdi", "2548963"));
+
+	std::cout << "test_parallel_filter() OK" << std::endl;
+	std::cout << "---------------------" << std::endl;
+}
+
+void test_erase_if(){
+	typedef set<int, equal_int, std::hash<int> > set_hash_type;
+	typedef set<voce, equal_voce, hash_voce, vector_storage> set_voce_type;
+
+	set_hash_type set1;
+	for(int k = 0; k < 1000; ++k)
+		set1.add(k);
+
+	assert(set1.erase_if(is_odd()) == 500);		//erase_if()
+	assert(set1.size() == 500 && set1[0] == 0 && set1[499] == 998);
+	assert(!set1.try_remove(1));			//indice hash aggiornato
+	assert(set1.retain_if([](int v){ return v < 10; }) == 495);	//retain_if()
+	assert(set1.size() == 5 && set1[4] == 8);
+
+	set_voce_type set2;
+	set2.add(voce("Mario", "Rossi", "6959595"));
+	set2.add(voce("Sara", "Verdi", "987654"));
+	set2.add(voce("Luca", "Rossi", "8855855"));
+	set2.add(voce("Deborah", "Verdi", "2548963"));
+
+	std::ostringstream view_out, filter_out_out;
+	view_out << filter_out_view(set2, voce_surname_Rossi());	//vista filtrata
+	filter_out_out << filter_out(set2, voce_surname_Rossi());
+	assert(view_out.str() == filter_out_out.str());
+
+	unsigned int count = 0;
+	typedef filtered_view<set_voce_type, voce_surname_Rossi> view_type;
+	view_type view = filter_out_view(set2, voce_surname_Rossi());
+	for(view_type::const_iterator i = view.begin(); i != view.end(); ++i, ++count)
+		assert(i->cognome == "Verdi");
+	assert(count == 2);
+
+	assert(set2.erase_if(voce_surname_Rossi()) == 2);	//compattazione dell'array
+	assert(set2.size() == 2 && set2[1] == voce("Deborah", "Verdi", "2548963"));
+	try{
+		set2.add(voce("Sara", "Verdi", "987654"));	//already_existing_exception
+		assert(false);
+	}catch(already_existing_exception){}
+
+	std::cout << "test_erase_if() OK" << std::endl;
+	std::cout << "---------------------" << std::endl;
+}
+
+void test_concurrent(){
+	typedef concurrent_set<int, equal_int> set_type;
+
+	set_type set1(4);
+	set1.add(1);
+	set1.add(2);
+	assert(!set1.try_add(2) && set1.try_add(3) && set1.size() == 3);
+	assert(set1.contains(2) && !set1.contains(4));
+	try{
+		set1.add(1);	//already_existing_exception
+		assert(false);
+	}catch(already_existing_exception){}
+	set1.remove(2);
+	assert(!set1.contains(2) && !set1.try_remove(2) && set1.size() == 2);
+	try{
+		set1.remove(2);	//not_existing_exception
+		assert(false);
+	}catch(not_existing_exception){}
+
+	set_type set2;
+	std::vector<std::thread> writers;
+	for(int t = 0; t < 4; ++t)	//scrittori concorrenti su intervalli disgiunti
+		writers.push_back(std::thread([&set2, t](){
+			for(int k = t * 1000; k < (t + 1) * 1000; ++k)
+				set2.add(k);
+			for(int k = t * 1000; k < (t + 1) * 1000; k += 2)
+				set2.remove(k);
+		}));
+	for(int t = 0; t < 4; ++t)
+		writers[t].join();
+	assert(set2.size() == 2000);
+
+	long long sum = 0;
+	for(set_type::const_iterator i = set2.begin(); i != set2.end(); ++i)
+		sum += *i;
+	assert(sum == 2000LL * 2000);	//somma dei dispari in [0, 4000)
+
+	unsigned int visited = 0;
+	set_type::const_iterator i = set2.begin();
+	std::thread eraser([&set2](){	//rimozione concorrente durante l'iterazione
+		set2.clear_set();
+		epoch_domain::instance().flush();
+	});
+	eraser.join();
+	for(; i != set2.end(); ++i, ++visited)
+		assert(*i % 2 == 1);
+	assert(visited <= 2000 && set2.size() == 0 && set2.begin() == set2.end());
+
+	std::cout << "test_concurrent() OK" << std::endl;
+	std::cout << "---------------------" << std::endl;
+}
+
+void test_frozen(){
+	typedef set<voce, equal_voce, hash_voce> set_voce_type;
+	typedef frozen_set<voce, equal_voce, hash_voce> frozen_voce_type;
+	typedef frozen_set<int, equal_int, std::hash<int> > frozen_int_type;
+
+	set_voce_type set1;
+	set1.add(voce("Mario", "Rossi", "6959595"));
+	set1.add(voce("Sara", "Verdi", "987654"));
+	set1.add(voce("Luca", "Rossi", "8855855"));
+
+	frozen_voce_type frozen1 = freeze(set1);	//freeze()
+	set1.remove(voce("Sara", "Verdi", "987654"));	//la copia non cambia
+	assert(frozen1.size() == 3 && frozen1[1] == voce("Sara", "Verdi", "987654"));
+	assert(frozen1.contains(voce("Luca", "Rossi", "8855855")));
+	assert(!frozen1.contains(voce("Luca", "Verdi", "8855855")));
+
+	set<int, equal_int> set2;		//senza indice hash
+	for(int k = 0; k < 10; ++k)
+		set2.add(k);
+	frozen_set<int, equal_int> frozen2 = freeze(set2);
+	std::ostringstream set_out, frozen_out;
+	set_out << set2;
+	frozen_out << frozen2;
+	assert(set_out.str() == frozen_out.str() && frozen2.contains(9) && !frozen2.contains(10));
+
+	snapshot_handle<frozen_int_type> handle;	//pubblicazione concorrente
+	assert(handle.read()->size() == 0);
+	std::thread reader([&handle](){
+		for(int r = 0; r < 2000; ++r){
+			snapshot_handle<frozen_int_type>::reader snapshot = handle.read();
+			int n = static_cast<int>(snapshot->size());
+			assert(n == 0 || (snapshot->contains(n - 1) && !snapshot->contains(n)));
+		}
+	});
+	set<int, equal_int, std::hash<int> > set3;
+	for(int k = 0; k < 200; ++k){
+		set3.add(k);
+		handle.publish(freeze(set3));
+	}
+	reader.join();
+	assert(handle.read()->size() == 200 && (*handle.read())[199] == 199);
+
+	std::cout << "test_frozen() OK" << std::endl;
+	std::cout << "---------------------" << std::endl;
+}
+
+/**
+	@brief Definizione del funtore per l'ordinamento tra voci
+
+	Funtore che ordina le voci per cognome, poi per nome e numero di telefono.
+**/
+struct less_voce{
+
+	bool operator()(const voce &a, const voce &b) const {
+		if(a.cognome != b.cognome)
+			return a.cognome < b.cognome;
+		if(a.nome != b.nome)
+			return a.nome < b.nome;
+		return a.ntel < b.ntel;
+	}
+};
+
+void test_ordered(){
+	typedef ordered_set<int> set_int_type;
+	typedef ordered_set<voce, less_voce> set_voce_type;
+
+	set_int_type set1;
+	std::vector<bool> present(20000, false);
+	unsigned int x = 12345, count = 0;
+	for(int k = 0; k < 100000; ++k){		//inserimenti e rimozioni casuali
+		x = x * 1103515245u + 12345u;
+		int v = static_cast<int>((x >> 8) % 20000);
+		if((x >> 30) != 0){
+			assert(set1.try_add(v) == !present[v]);
+			count += !present[v];
+			present[v] = true;
+		}
+		else{
+			assert(set1.try_remove(v) == present[v]);
+			count -= present[v];
+			present[v] = false;
+		}
+	}
+	assert(set1.size() == count);
+
+	int previous = -1;
+	unsigned int visited = 0;
+	for(set_int_type::const_iterator i = set1.begin(); i != set1.end(); ++i, ++visited){
+		assert(*i > previous && present[*i]);	//ordine crescente
+		previous = *i;
+	}
+	assert(visited == count && set1.min() == *set1.begin() && set1.max() == previous);
+
+	for(int v = 0; v < 20000; v += 7){
+		set_int_type::const_iterator lb = set1.lower_bound(v), ub = set1.upper_bound(v);
+		int expected = v;
+		while(expected < 20000 && !present[expected])
+			expected++;
+		assert(expected == 20000 ? lb == set1.end() : *lb == expected);	//lower_bound()
+		assert(set1.contains(v) == present[v]);
+		if(present[v])
+			assert(ub == ++lb);				//upper_bound()
+		else
+			assert(ub == lb);
+	}
+
+	visited = 0;
+	for(int v : set1.range(1000, 2000)){		//range()
+		assert(v >= 1000 && v < 2000 && present[v]);
+		visited++;
+	}
+	for(int v = 1000; v < 2000; ++v)
+		visited -= present[v];
+	assert(visited == 0);
+
+	set_int_type set2(set1);				//copia e filter_out
+	set_int_type set3 = filter_out(set2, is_odd());
+	for(int v = 0; v < 20000; ++v)
+		if(present[v])
+			set1.remove(v);
+	assert(set1.size() == 0 && set1.begin() == set1.end());
+	try{
+		set1.remove(0);	//not_existing_exception
+		assert(false);
+	}catch(not_existing_exception){}
+	assert(set2.size() == count);
+	for(int v : set3)
+		assert(v % 2 == 0 && set2.contains(v));
+
+	set_voce_type set4;
+	set4.add(voce("Sara", "Verdi", "987654"));
+	set4.add(voce("Mario", "Rossi", "6959595"));
+	set4.add(voce("Luca", "Rossi", "8855855"));
+	try{
+		set4.add(voce("Mario", "Rossi", "6959595"));	//already_existing_exception
+		assert(false);
+	}catch(already_existing_exception){}
+
+	std::ostringstream out;
+	out << filter_out(set4, voce_surname_Rossi()) << set4;
+	std::ostringstream expected;
+	expected << voce("Sara", "Verdi", "987654") << " " << voce("Luca", "Rossi", "8855855") << " "
+		<< voce("Mario", "Rossi", "6959595") << " " << voce("Sara", "Verdi", "987654") << " ";
+	assert(out.str() == expected.str());
+
+	std::cout << "test_ordered() OK" << std::endl;
+	std::cout << "---------------------" << std::endl;
+}
+
+/**
+	@brief Verifica la ricerca SIMD per un tipo aritmetico
+
+	Riempie un set di n valori, ne rimuove uno ogni tre (lasciando lapidi
+	che contengono ancora il vecchio valore) e controlla ricerca e duplicati.
+	@param n Numero di valori.
+**/
+template <typename T>
+void check_simd_set(int n){
+
+	set<T> s;
+	for(int k = 0; k < n; ++k)
+		s.add(static_cast<T>(k));
+	for(int k = 0; k < n; k += 3)
+		s.remove(static_cast<T>(k));
+	for(int k = 0; k < n; ++k)
+		assert(s.try_add(static_cast<T>(k)) == (k % 3 == 0));	//le lapidi non vengono trovate
+	assert(s.size() == static_cast<unsigned int>(n));
+	try{
+		s.add(static_cast<T>(n - 1));	//already_existing_exception
+		assert(false);
+	}catch(already_existing_exception){}
+	assert(!s.try_remove(static_cast<T>(n)) && s.try_remove(static_cast<T>(n - 1)));
+}
+
+void test_simd(){
+	static_assert(std::is_same<set<int>, set<int, std::equal_to<int>, no_hash, vector_storage> >::value,
+		"set<int> should default to vector_storage");
+	static_assert(std::is_same<set<int, equal_int>, set<int, equal_int, no_hash, list_storage> >::value,
+		"custom functors keep list_storage");
+
+	check_simd_set<int>(1000);
+	check_simd_set<char>(100);
+	check_simd_set<unsigned short>(1000);
+	check_simd_set<long long>(1000);
+	check_simd_set<float>(1000);
+	check_simd_set<double>(1000);
+
+	set<double> set1;
+	set1.add(-0.0);
+	assert(!set1.try_add(0.0));	//uguaglianza IEEE, non bit a bit
+
+	set<int> set2;
+	for(int k = 0; k < 8; ++k)
+		set2.add(k);
+	set2.remove(3);		//lapide nel mezzo dell'array
+	for(int k = 8; k < 100; ++k)	//grow copia anche la lapide
+		set2.add(k);
+	assert(!set2.contains(3) && set2.contains(4) && set2.size() == 99);
+	set2.add(3);
+	assert(set2.size() == 100 && set2[99] == 3);
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	long long values[37];
+	for(int k = 0; k < 37; ++k)
+		values[k] = (static_cast<long long>(k) << 32) | 7;
+	for(int k = 0; k < 37; ++k)		//versione SSE2 anche su processori AVX2
+		assert(set_detail::scan_sse2(values, 37, values[k]) == static_cast<std::size_t>(k));
+	assert(set_detail::scan_sse2(values, 37, 7LL) == 0 && set_detail::scan_sse2(values, 37, 8LL) == 37);
+#endif
+
+	std::cout << "test_simd() OK" << std::endl;
+	std::cout << "---------------------" << std::endl;
+}
+
+void test_small_storage(){
+	typedef set<int, equal_int, std::hash<int>, small_storage<8>, counting_allocator<int> > set_small_type;
+	typedef set<voce, equal_voce, hash_voce, small_storage<2> > set_voce_type;
+
+	long long before = counting_allocator<int>::allocations();
+	set_small_type set1;
+	for(int k = 0; k < 8; ++k)
+		set1.add(k);
+	assert(!set1.try_add(3) && set1.try_remove(3) && set1.try_add(3));
+	assert(counting_allocator<int>::allocations() == before);	//nessuna allocazione
+	set1.add(8);						//oltre il buffer interno
+	assert(counting_allocator<int>::allocations() > before);
+
+	std::vector<int> expected(set1.begin(), set1.end());
+	unsigned int x = 7;
+	for(int r = 0; r < 5000; ++r){		//attraversamenti ripetuti della soglia
+		x = x * 1103515245u + 12345u;
+		int v = static_cast<int>((x >> 16) % 14);
+		bool present = std::find(expected.begin(), expected.end(), v) != expected.end();
+		if((x >> 30) & 1){
+			assert(set1.try_add(v) == !present);
+			if(!present)
+				expected.push_back(v);
+		}
+		else{
+			assert(set1.try_remove(v) == present);
+			if(present)
+				expected.erase(std::find(expected.begin(), expected.end(), v));
+		}
+		assert(set1.size() == expected.size());
+	}
+	for(unsigned int k = 0; k < expected.size(); ++k)
+		assert(set1[k] == expected[k]);		//ordine di inserimento
+
+	set_small_type set2(set1);			//copia, spostamento e scambio
+	set_small_type set3;
+	set3.add(100);
+	set3.swap(set2);
+	assert(set2.size() == 1 && set2[0] == 100 && set3.size() == set1.size());
+	set_small_type set4(std::move(set3));
+	assert(set3.size() == 0 && set4.size() == set1.size() && set4.try_add(100));
+
+	set_voce_type set5;
+	set5.add(voce("Mario", "Rossi", "6959595"));
+	set5.add(voce("Sara", "Verdi", "987654"));
+	set5.add(voce("Luca", "Rossi", "8855855"));
+	assert(set5.erase_if(voce_surname_Rossi()) == 2);
+	assert(set5.size() == 1 && set5[0] == voce("Sara", "Verdi", "987654"));
+	try{
+		set5.add(voce("Sara", "Verdi", "987654"));	//already_existing_exception
+		assert(false);
+	}catch(already_existing_exception){}
+
+	std::cout << "test_small_storage() OK" << std::endl;
+	std::cout << "---------------------" << std::endl;
+}
+
+void test_lookup(){
+	typedef set<int, equal_int> set_int_type;
+	typedef set<voce, equal_voce_ntel, hash_voce_ntel> set_voce_type;
+
+	set_int_type set1;
+	set1.add(1);
+	set1.add(2);
+	set1.add(3);
+	assert(set1.contains(2) && !set1.contains(4));	//contains()
+	assert(set1.count(3) == 1 && set1.count(5) == 0);	//count()
+	set_int_type::const_iterator i = set1.find(2);	//find()
+	assert(i != set1.end() && *i == 2 && *++i == 3);
+	assert(set1.find(4) == set1.end());
+
+	set_voce_type set2;
+	set2.add(voce("Mario", "Rossi", "6959595"));
+	set2.add(voce("Sara", "Verdi", "987654"));
+	set_voce_type::const_iterator j = set2.find(std::string("987654"));	//ricerca eterogenea
+	assert(j != set2.end() && j->nome == "Sara");
+	assert(set2.contains(std::string("6959595")) && !set2.contains(std::string("000")));
+	assert(set2.count(std::string("6959595")) == 1);
+	assert(set2.contains(voce("Luigi", "Bianchi", "6959595")));	//stesso numero di telefono
+
+	std::cout << "test_lookup() OK" << std::endl;
+	std::cout << "---------------------" << std::endl;
+}
+
+void test_io(){
+	typedef set<int, equal_int> set_int_type;
+	typedef set<voce, equal_voce, hash_voce> set_voce_type;
+	typedef mapped_set<voce, equal_voce, hash_voce> mapped_voce_type;
+
+	set_int_type set1;
+	for(int k = 0; k < 100; ++k)
+		set1.add(k * 3);
+	std::stringstream ss1;
+	save_binary(ss1, set1);	//save_binary() senza indice
+	set_int_type set2;
+	set2.add(-1);
+	load_binary(ss1, set2);	//load_binary()
+	assert(set2.size() == 100 && std::equal(set1.begin(), set1.end(), set2.begin()));
+
+	set_voce_type set3;
+	set3.add(voce("Mario", "Rossi", "6959595"));
+	set3.add(voce("Sara", "Verdi", "987654"));
+	set3.add(voce("", "Bianchi", "12345"));	//campo vuoto
+	std::stringstream ss2;
+	save_binary(ss2, set3);	//save_binary() con indice
+	set_voce_type set4;
+	load_binary(ss2, set4);
+	assert(set4.size() == 3 && std::equal(set3.begin(), set3.end(), set4.begin()));
+	assert(set4[2].cognome == "Bianchi" && set4.contains(voce("Mario", "Rossi", "6959595")));
+
+	std::stringstream ss3("SETFILE non valido");	//file non valido
+	try{
+		load_binary(ss3, set4);
+		assert(false);
+	}catch(set_file_exception &e){
+		assert(set4.size() == 3);	//set invariato
+	}
+
+	set<int, equal_int, std::hash<int> > set7;	//elemento duplicato nel file
+	set7.add(1);
+	set7.add(2);
+	std::stringstream ss5;
+	save_binary(ss5, set7);
+	std::string dup = ss5.str();
+	int one = 1;
+	dup.replace(sizeof(set_detail::file_header) + sizeof(int), sizeof(int), reinterpret_cast<const char *>(&one), sizeof(int));
+	std::stringstream ss6(dup);
+	try{
+		load_binary(ss6, set7);
+		assert(false);
+	}catch(set_file_exception &e){
+		assert(set7.size() == 2 && set7.contains(2));
+	}
+
+	std::string bytes = ss2.str();
+	set_detail::file_header header;
+	std::memcpy(&header, bytes.data(), sizeof(header));
+	header.data_size = 1ull << 40;	//sezioni oltre la fine del file
+	header.offsets = 1ull << 41;
+	std::stringstream ss4(std::string(reinterpret_cast<const char *>(&header), sizeof(header)) + bytes.substr(sizeof(header)));
+	try{
+		load_binary(ss4, set4);
+		assert(false);
+	}catch(set_file_exception &e){
+		assert(set4.size() == 3);
+	}
+
+	char path[] = "/tmp/set_io_XXXXXX";
+	int fd = mkstemp(path);
+	assert(fd >= 0);
+	assert(write(fd, bytes.data(), bytes.size()) == static_cast<ssize_t>(bytes.size()));
+	close(fd);
+
+	{
+		mapped_voce_type set5(path);	//mapped_set
+		assert(set5.size() == 3);
+		assert(set5.contains(voce("Sara", "Verdi", "987654")));
+		assert(!set5.contains(voce("Sara", "Verdi", "000")));
+		assert(set5[0] == set3[0]);
+		mapped_voce_type::const_iterator i = set5.begin();
+		assert((*++i).nome == "Sara");
+		std::cout << set5 << std::endl;
+	}
+
+	for(std::uint64_t j = 0; j < header.slot_count; ++j){	//indice senza celle vuote
+		std::uint32_t one = 1;
+		bytes.replace(header.slots + j * sizeof(one), sizeof(one), reinterpret_cast<const char *>(&one), sizeof(one));
+	}
+	fd = open(path, O_WRONLY | O_TRUNC);
+	assert(fd >= 0 && write(fd, bytes.data(), bytes.size()) == static_cast<ssize_t>(bytes.size()));
+	close(fd);
+	try{
+		mapped_voce_type set6(path);
+		assert(false);
+	}catch(set_file_exception &e){}
+	std::remove(path);
+
+	std::cout << "test_io() OK" << std::endl;
+	std::cout << "---------------------" << std::endl;
+}
+
+/**
+	@brief Legge il contenuto di un FILE* dall'inizio
+
+	@param file FILE* da leggere.
+	@return Il contenuto del file.
+**/
+std::string read_file(std::FILE *file){
+	std::string text;
+	char chunk[256];
+	std::fflush(file);
+	std::rewind(file);
+	for(std::size_t n; (n = std::fread(chunk, 1, sizeof(chunk), file)) > 0; )
+		text.append(chunk, n);
+	return text;
+}
+
+void test_write(){
+	typedef set<int, equal_int> set_int_type;
+	typedef set<double> set_double_type;
+	typedef set<std::string, equal_string> set_string_type;
+	typedef set<voce, equal_voce, hash_voce> set_voce_type;
+
+	set_int_type set1;
+	for(int k = -50000; k < 50000; k += 7)
+		set1.add(k);
+	set_double_type set2;
+	set2.add(0.1);
+	set2.add(-2.5e-10);
+	set2.add(123456789.0);
+	set_string_type set3;
+	set3.add("pippo");
+	set3.add("pluto");
+	set_voce_type set4;
+	set4.add(voce("Mario", "Rossi", "6959595"));
+
+	std::ostringstream expected;
+	expected << set1 << set2 << set3 << set4;
+
+	std::FILE *file = std::tmpfile();
+	assert(file != 0);
+	write_to(file, set1);	//write_to() con to_chars
+	write_to(file, set2);
+	write_to(file, set3);
+	std::fflush(file);
+	write_to(fileno(file), set4);	//write_to() su file descriptor, operator<< di voce
+	assert(read_file(file) == expected.str());
+	std::fclose(file);
+
+	file = std::tmpfile();
+	write_to(file, set3, [](output_buffer &out, const std::string &v){	//formattazione personalizzata
+		out.put('"');
+		out.append(v.data(), v.size());
+		out.put('"');
+	});
+	assert(read_file(file) == "\"pippo\" \"pluto\" ");
+	std::fclose(file);
+
+	set<long long, std::equal_to<long long> > set5;	//interi più lunghi: buffer da digits10 + 3
+	set5.add(std::numeric_limits<long long>::min());
+	set5.add(std::numeric_limits<long long>::max());
+	set<unsigned long long, std::equal_to<unsigned long long> > set6;
+	set6.add(std::numeric_limits<unsigned long long>::max());
+	file = std::tmpfile();
+	write_to(file, set5);
+	write_to(file, set6);
+	assert(read_file(file) == "-9223372036854775808 9223372036854775807 18446744073709551615 ");
+	std::fclose(file);
+
+	std::cout << "test_write() OK" << std::endl;
+	std::cout << "---------------------" << std::endl;
+}
+
+void test_stats(){
+	typedef set<int, equal_int, std::hash<int>, list_storage, std::allocator<int>, counting_stats> set_int_type;
+	typedef set<int, std::equal_to<int>, no_hash, vector_storage, std::allocator<int>, sampled_stats<1> > set_simd_type;
+
+	static_assert(sizeof(set<int, equal_int, std::hash<int> >) < sizeof(set_int_type), "no_stats non occupa memoria");
+
+	set_int_type set1;
+	set1.add(1);
+	set1.add(2);
+	set1.add(3);
+	assert(!set1.try_add(2));	//duplicato
+	try{
+		set1.add(3);
+		assert(false);
+	}catch(already_existing_exception &e){}
+	set1.remove(2);
+	assert(set1.contains(1) && !set1.contains(7));
+
+	set_stats st = set1.stats();	//stats()
+	assert(st.adds == 3 && st.removes == 1 && st.duplicates == 2);
+	assert(st.lookups == 3 + 2 + 1 + 2);	//add, duplicati, remove, contains
+	assert(st.visited == 2 + 1 + 1 && st.max_visited == 1);	//un solo confronto per elemento trovato
+	assert(st.allocations >= 3 && st.samples == 0);
+
+	set_int_type set2(set1);	//i contatori non vengono copiati
+	assert(set2.stats().adds == 0);
+	set1.reset_stats();	//reset_stats()
+	assert(set1.stats().lookups == 0);
+
+	set_simd_type set3;	//scansione lineare e latenze
+	for(int k = 0; k < 100; ++k)
+		set3.add(k);
+	assert(set3.contains(99));
+	st = set3.stats();
+	assert(st.max_visited == 100 && st.samples == 101);
+	unsigned long long samples = 0;
+	for(unsigned int i = 0; i < set_stats::buckets; ++i)
+		samples += st.latency[i];
+	assert(samples == st.samples);
+
+	std::string json = to_json(st);	//to_json()
+	assert(json.find("\"max_visited\": 100") != std::string::npos);
+	assert(json.front() == '{' && json.back() == '}');
+	std::cout << json << std::endl;
+
+	set<int, equal_int> set4;	//no_stats
+	set4.add(1);
+	assert(set4.stats().adds == 0);
+
+	std::cout << "test_stats() OK" << std::endl;
+	std::cout << "---------------------" << std::endl;
+}
+
+void test_compact(){
+	typedef set<int, equal_int, no_hash, compact_storage> set_int_type;
+	typedef set<voce, equal_voce, hash_voce, compact_storage> set_voce_type;
+
+	static_assert(std::is_same<decltype(set_int_type().size()), std::size_t>::value, "size_type a 64 bit");
+	static_assert(std::is_same<decltype(frozen_set<int, equal_int>().size()), std::size_t>::value, "size_type a 64 bit");
+	static_assert(std::is_same<decltype(ordered_set<int>().size()), std::size_t>::value, "size_type a 64 bit");
+	static_assert(std::is_same<decltype(std::declval<concurrent_set<int, equal_int> &>().size()), std::size_t>::value,
+		"size_type a 64 bit");
+	static_assert(std::is_same<decltype(std::declval<mapped_set<int, equal_int> &>().size()), std::size_t>::value,
+		"size_type a 64 bit");
+
+	set_int_type set1;
+	for(int k = 0; k < 20; ++k)
+		set1.add(k);
+	set1.remove(0);	//testa
+	set1.remove(19);	//coda
+	set1.remove(7);	//in mezzo
+	assert(set1.size() == 17 && set1[0] == 1 && set1[6] == 8);
+	set1.add(100);	//riusa una cella libera, in coda alla lista
+	set1.add(101);
+	assert(set1[18] == 101 && set1.contains(100) && !set1.contains(7));
+
+	set_int_type set2(set1);	//copia
+	assert(std::equal(set1.begin(), set1.end(), set2.begin()) && set2.size() == set1.size());
+	assert(set2.erase_if([](int v){ return v % 2 == 0; }) == 10);	//erase_if()
+	assert(set2.size() == 9 && set2[0] == 1 && set2[8] == 101);
+	set2 = set1;	//operator=
+	assert(set2.size() == 19);
+	set2.clear_set();
+	assert(set2.size() == 0 && set2.begin() == set2.end());
+
+	set_voce_type set3;
+	for(int k = 0; k < 50; ++k)
+		set3.add(voce("Nome", "Cognome", std::to_string(k)));
+	for(int k = 0; k < 50; k += 2)
+		set3.remove(voce("Nome", "Cognome", std::to_string(k)));
+	for(int k = 50; k < 80; ++k)	//riuso delle celle e raddoppio dell'array
+		set3.add(voce("Nome", "Cognome", std::to_string(k)));
+	assert(set3.size() == 55);
+	assert(set3.contains(voce("Nome", "Cognome", "49")) && !set3.contains(voce("Nome", "Cognome", "48")));
+	assert(set3[0].ntel == "1" && set3[24].ntel == "49" && set3[25].ntel == "50");
+
+	set_voce_type set4(std::move(set3));	//spostamento
+	assert(set4.size() == 55 && set3.size() == 0);
+
+	std::cout << "test_compact() OK" << std::endl;
+	std::cout << "---------------------" << std::endl;
+}
+
+void test_trivial(){
+	typedef list_storage::container<int, std::allocator<int> > list_type;
+	typedef set<int, std::equal_to<int>, no_hash, vector_storage> set_vector_type;
+	typedef set<int, equal_int, no_hash, small_storage<4> > set_small_type;
+	typedef set<int, equal_int, std::hash<int>, compact_storage> set_compact_type;
+
+	//i funtori privi di stato non occupano memoria
+	static_assert(sizeof(set<int, equal_int>) ==
+		sizeof(list_type) + sizeof(std::vector<list_type::handle>) + sizeof(void *), "EBO dei funtori");
+
+	set_vector_type set1;
+	for(int k = 0; k < 100; ++k)
+		set1.add(k);
+	set1.remove(50);	//con una lapide la copia procede elemento per elemento
+	set_vector_type set2(set1);
+	assert(set2.size() == 99 && std::equal(set1.begin(), set1.end(), set2.begin()));
+	set_vector_type set3(set2);	//copia con memcpy
+	assert(set3.size() == 99 && set3[50] == 51 && set3.contains(99) && !set3.contains(50));
+
+	set_small_type set4;
+	for(int k = 0; k < 10; ++k)
+		set4.add(k);
+	set_small_type set5(set4);
+	assert(set5.size() == 10 && set5[9] == 9 && set5.contains(3));
+
+	set_compact_type set6;
+	for(int k = 0; k < 20; ++k)
+		set6.add(k);
+	set6.remove(3);
+	set6.remove(10);
+	set_compact_type set7(set6);	//copia dei nodi con le celle libere
+	assert(set7.size() == 18 && std::equal(set6.begin(), set6.end(), set7.begin()));
+	set7.add(100);	//riusa una cella libera copiata
+	set7.add(101);
+	set7.add(102);
+	assert(set7.size() == 21 && set7[20] == 102 && set7.contains(100) && !set7.contains(10));
+
+	constexpr fixed_set<int, 4> primes(2, 3, 5, 7);	//fixed_set
+	static_assert(primes.contains(5) && !primes.contains(4), "ricerca constexpr");
+	static_assert(primes.size() == 4 && primes[3] == 7, "accesso constexpr");
+	constexpr auto keywords = make_fixed_set(std::string_view("if"), std::string_view("else"), std::string_view("for"));
+	static_assert(keywords.contains("for") && !keywords.contains("while"), "ricerca constexpr");
+	try{
+		fixed_set<int, 3> dup(1, 2, 1);	//duplicato
+		assert(false);
+	}catch(already_existing_exception &e){}
+
+	std::cout << primes << std::endl;
+	std::cout << "test_trivial() OK" << std::endl;
+	std::cout << "---------------------" << std::endl;
+}
+
+void test_string_set(){
+
+	std::cout << "test_string_set()" << std::endl;
+
+	string_set set1;
+	std::string name = "identificatore";
+	set1.add(std::string_view(name).substr(0, 5));	//"ident", senza stringhe temporanee
+	set1.add("alfa");
+	set1.add("beta");
+	set1.add("");	//la stringa vuota è un elemento valido
+	assert(set1.size() == 4 && set1.contains("ident") && set1.contains("") && !set1.contains("iden"));
+	assert(set1[0] == "ident" && set1[1] == "alfa" && set1[3] == "");
+	assert(!set1.try_add("alfa") && set1.count("beta") == 1);
+	try{
+		set1.add("beta");	//duplicato
+		assert(false);
+	}catch(already_existing_exception &e){}
+
+	set1.remove("alfa");	//lapide: operator[] usa la tabella delle posizioni
+	assert(set1.size() == 3 && !set1.contains("alfa") && set1[1] == "beta" && set1[2] == "");
+	set1.add("gamma");
+	assert(set1[3] == "gamma" && set1.contains("gamma"));
+	try{
+		set1.remove("alfa");	//non esistente
+		assert(false);
+	}catch(not_existing_exception &e){}
+
+	std::vector<std::string> expected = {"ident", "beta", "", "gamma"};
+	assert(std::equal(set1.begin(), set1.end(), expected.begin(), expected.end()));
+
+	string_set set2;
+	for(int k = 0; k < 1000; ++k)
+		set2.add("id_" + std::to_string(k));
+	for(int k = 0; k < 1000; k += 2)
+		set2.remove("id_" + std::to_string(k));
+	assert(set2.size() == 500 && set2[0] == "id_1" && set2[499] == "id_999");
+	set2.remove("id_1");	//oltre metà lapidi: compattazione
+	assert(set2.size() == 499 && set2[0] == "id_3" && set2.arena_size() < 3000);
+	for(int k = 0; k < 1000; ++k)
+		assert(set2.contains("id_" + std::to_string(k)) == (k % 2 == 1 && k != 1));
+
+	string_set set4;
+	set4.add("keep");
+	for(int k = 0; k < 100000; ++k){	//aggiunta e rimozione in coda
+		set4.add("temporary-identifier");
+		set4.remove("temporary-identifier");
+	}
+	assert(set4.size() == 1 && set4.arena_size() == 4);
+	set4.add("a");
+	set4.add("b");
+	set4.remove("a");	//lapide seguita da una stringa presente
+	set4.remove("b");	//entrambe scartate
+	assert(set4.size() == 1 && set4.arena_size() == 4 && set4[0] == "keep");
+
+	set2.remove("id_5");	//remove() toglie una sola posizione dalla tabella
+	assert(set2.size() == 498 && set2[1] == "id_7" && set2[497] == "id_999");
+
+	const string_set set5(set2);	//costruzione della tabella da più thread
+	std::vector<std::thread> readers;
+	std::vector<std::size_t> chars(4, 0);
+	for(int t = 0; t < 4; ++t){
+		readers.push_back(std::thread([&set5, &chars, t](){
+			for(std::size_t k = 0; k < set5.size(); ++k)
+				chars[t] += set5[k].size();
+		}));
+	}
+	for(std::size_t t = 0; t < readers.size(); ++t)
+		readers[t].join();
+	for(std::size_t t = 1; t < chars.size(); ++t)
+		assert(chars[t] == chars[0]);
+	string_set set6(std::move(set4));
+	set4 = set5;
+	assert(set6[0] == "keep" && set4.size() == 498 && set4[1] == "id_7");
+
+	string_set set3(expected.begin(), expected.end());
+	set3.swap(set2);
+	assert(set2.size() == 4 && set3.size() == 498);
+	set3.clear_set();
+	assert(set3.size() == 0 && set3.begin() == set3.end() && !set3.contains("id_3"));
+
+	std::cout << set1 << std::endl;
+	std::cout << "test_string_set() OK" << std::endl;
+	std::cout << "---------------------" << std::endl;
+}
+
+void test_indexed(){
+	typedef indexed_set<voce, equal_voce, hash_voce> set_voce_type;
+
+	std::cout << "test_indexed()" << std::endl;
+
+	set_voce_type set1;
+	set1.add(voce("Mario", "Rossi", "1"));
+	set1.add(voce("Luca", "Bianchi", "2"));
+	set_voce_type::key_index<std::string, std::hash<std::string>, std::equal_to<std::string> > by_surname =
+		set1.add_index(&voce::cognome);	//indice costruito sugli elementi esistenti
+	auto by_ntel = set1.add_index(&voce::ntel);
+	set1.add(voce("Anna", "Rossi", "3"));
+	set1.add(voce("Piero", "Neri", "4"));
+	set1.add(voce("Giulia", "Rossi", "5"));
+
+	set_voce_type::match_range r = set1.equal_range(by_surname, "Rossi");	//equal_range
+	std::vector<std::string> names;
+	for(set_voce_type::match_iterator i = r.first; i != r.second; ++i)
+		names.push_back(i->nome);
+	assert((names == std::vector<std::string>{"Mario", "Anna", "Giulia"}));
+	assert(&*r.first == &set1[0]);	//nessuna copia: l'iteratore riferisce l'elemento del set
+	assert(set1.count(by_surname, "Verdi") == 0 && set1.count(by_ntel, "4") == 1);
+	r = set1.equal_range(by_surname, "Verdi");
+	assert(r.first == r.second);
+
+	set1.remove(voce("Anna", "Rossi", "3"));	//remove
+	assert(set1.count(by_surname, "Rossi") == 2 && set1.count(by_ntel, "3") == 0);
+	set1.remove(voce("Piero", "Neri", "4"));	//ultimo elemento del gruppo
+	assert(set1.count(by_surname, "Neri") == 0 && set1.count(by_surname, "Bianchi") == 1);
+	assert(!set1.try_add(voce("Mario", "Rossi", "1")) && set1.count(by_surname, "Rossi") == 2);
+
+	set_voce_type set2(set1);	//copia: gli indici vengono ricostruiti sulla copia
+	set1.erase_if(voce_surname_Rossi());	//erase_if
+	assert(set1.size() == 1 && set1.count(by_surname, "Rossi") == 0 && set1.count(by_ntel, "5") == 0);
+	assert(set2.size() == 3 && set2.count(by_surname, "Rossi") == 2);
+	assert(&*set2.equal_range(by_ntel, "5").first == &set2[2]);
+
+	set_voce_type set3(std::move(set2));	//spostamento
+	assert(set3.count(by_surname, "Rossi") == 2);
+	set3.clear_set();
+	assert(set3.size() == 0 && set3.count(by_surname, "Rossi") == 0);
+	set3.add(voce("Mario", "Rossi", "1"));
+	assert(set3.count(by_surname, "Rossi") == 1);
+
+	try{
+		set2.count(by_surname, "Rossi");	//set spostato: non ha più indici
+		assert(false);
+	}catch(std::invalid_argument &e){}
+	set_voce_type set4;
+	set4.add_index(&voce::nome);
+	try{
+		set4.count(by_surname, "Rossi");	//indice di un altro set nella stessa posizione
+		assert(false);
+	}catch(std::invalid_argument &e){}
+
+	try{
+		set1.remove(voce("Anna", "Rossi", "3"));	//not_existing_exception
+		assert(false);
+	}catch(not_existing_exception &e){}
+
+	std::cout << set1 << std::endl;
+	std::cout << "test_indexed() OK" << std::endl;
+	std::cout << "---------------------" << std::endl;
+}
+
 int main(void){
 
 	test_int();
 	test_string();
 	test_voce();
+	test_hash();
+	test_vector_storage();
+	test_operator_index();
+	test_node_pool();
+	test_move();
+	test_copy();
+	test_try();
+	test_algebra();
+	test_bulk();
+	test_parallel_filter();
+	test_erase_if();
+	test_concurrent();
+	test_frozen();
+	test_ordered();
+	test_simd();
+	test_small_storage();
+	test_lookup();
+	test_io();
+	test_write();
+	test_stats();
+	test_compact();
+	test_trivial();
+	test_string_set();
+	test_indexed();
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,289 @@
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+#include <cstddef>	//size_t
+#include <new>	//operator new
+#include <memory>	//shared_ptr, unique_ptr
+#include <vector>	//vector
+#include <type_traits>	//true_type
+
+/**
+	@file node_pool.h
+	@brief Dichiarazione dell'allocatore node_pool_allocator
+**/
+
+namespace node_pool_detail{
+
+/**
+	@brief Pool di blocchi di una stessa dimensione
+
+	Struttura che contiene le slab allocate e la free list. Un blocco libero
+	contiene il puntatore al blocco libero successivo, un blocco in uso un oggetto.
+	Le slab hanno dimensione crescente (raddoppiano ad ogni allocazione) fino a
+	max_slab blocchi.
+**/
+struct pool{
+
+	/**
+		@brief Blocco libero
+	**/
+	struct block{
+		block *next;	///< Blocco libero successivo nella free list
+	};
+
+	std::vector<unsigned char *> slabs;	///< Slab allocate
+	block *free_list;	///< Testa della free list
+	unsigned char *cursor;	///< Prossimo blocco mai utilizzato della slab corrente
+	unsigned char *slab_end;	///< Fine della slab corrente
+	std::size_t size;	///< Dimensione in byte di un blocco
+	std::size_t next_slab;	///< Numero di blocchi della prossima slab
+	std::size_t max_slab;	///< Numero massimo di blocchi per slab
+
+	pool(std::size_t block_size, std::size_t max_blocks)
+		: free_list(0), cursor(0), slab_end(0), size(block_size), next_slab(16), max_slab(max_blocks) {}
+
+	pool(const pool &other) = delete;
+	pool &operator=(const pool &other) = delete;
+
+	~pool(){
+		release();
+	}
+
+	/**
+		@brief Preleva un blocco
+
+		Preleva un blocco dalla free list o, se vuota, dalla slab corrente,
+		allocando una nuova slab quando quella corrente è esaurita.
+		@return Il puntatore al blocco.
+	**/
+	void *take(void){
+
+		if(free_list != 0){
+			block *b = free_list;
+			free_list = b->next;
+			return b;
+		}
+
+		if(cursor == slab_end){
+			slabs.reserve(slabs.size() + 1);
+			unsigned char *slab = static_cast<unsigned char *>(::operator new(next_slab * size));
+			slabs.push_back(slab);
+			cursor = slab;
+			slab_end = slab + next_slab * size;
+			if(next_slab < max_slab)
+				next_slab = next_slab * 2 < max_slab ? next_slab * 2 : max_slab;
+		}
+		void *b = cursor;
+		cursor += size;
+		return b;
+	}
+
+	/**
+		@brief Restituisce un blocco
+
+		@param p Blocco da inserire in testa alla free list.
+	**/
+	void give(void *p){
+		block *b = static_cast<block *>(p);
+		b->next = free_list;
+		free_list = b;
+	}
+
+	/**
+		@brief Libera tutte le slab
+
+		Restituisce al sistema tutta la memoria del pool.
+	**/
+	void release(void){
+		for(std::size_t i = 0; i < slabs.size(); ++i)
+			::operator delete(slabs[i]);
+		slabs.clear();
+		free_list = 0;
+		cursor = 0;
+		slab_end = 0;
+		next_slab = 16;
+	}
+};
+
+/**
+	@brief Gruppo di pool condiviso dalle conversioni di un allocatore
+
+	Contiene un pool per ogni dimensione di blocco richiesta dagli allocatori
+	del gruppo, che sono pochi (uno per tipo convertito): la ricerca è lineare.
+**/
+struct pool_group{
+	std::vector<std::unique_ptr<pool> > pools;	///< Pool del gruppo, uno per dimensione
+
+	/**
+		@brief Pool per blocchi di una dimensione
+
+		@param size Dimensione in byte di un blocco.
+		@param max_slab Numero massimo di blocchi per slab, usato se il pool viene creato.
+		@return Il pool, creato se non ancora presente.
+	**/
+	pool *find(std::size_t size, std::size_t max_slab){
+		for(std::size_t i = 0; i < pools.size(); ++i)
+			if(pools[i]->size == size)
+				return pools[i].get();
+		pools.reserve(pools.size() + 1);
+		pools.push_back(std::unique_ptr<pool>(new pool(size, max_slab)));
+		return pools.back().get();
+	}
+
+	/**
+		@brief Libera tutte le slab di tutti i pool
+	**/
+	void release(void){
+		for(std::size_t i = 0; i < pools.size(); ++i)
+			pools[i]->release();
+	}
+};
+
+}
+
+/**
+	@brief Allocatore a pool per nodi
+
+	Allocatore che ritaglia gli oggetti di tipo T da grandi blocchi di memoria (slab)
+	e ricicla quelli deallocati tramite una free list, evitando una chiamata a malloc/free
+	per ogni nodo. Le slab hanno dimensione crescente (raddoppiano ad ogni allocazione)
+	fino a MaxSlab oggetti, e vengono restituite al sistema tutte insieme quando il pool
+	viene distrutto o tramite release().
+	Le richieste di più oggetti contigui (n > 1) vengono inoltrate a operator new.
+
+	Le copie di un allocatore e le sue conversioni verso altri tipi (rebind) condividono
+	lo stesso gruppo di pool, con un pool per ogni dimensione dei blocchi: per questo
+	node_pool_allocator<T>(node_pool_allocator<U>(a)) == a, e la memoria allocata da
+	un allocatore può essere deallocata da qualsiasi altro uguale ad esso.
+	La copia di un contenitore crea invece un gruppo nuovo.
+	@param T Tipo degli oggetti allocati.
+	@param MaxSlab Numero massimo di oggetti per slab.
+**/
+template <typename T, std::size_t MaxSlab = 16384>
+class node_pool_allocator{
+
+	template <typename U, std::size_t M>
+	friend class node_pool_allocator;
+
+	static const std::size_t block_align = alignof(T) > alignof(node_pool_detail::pool::block) ?
+		alignof(T) : alignof(node_pool_detail::pool::block);	///< Allineamento di un blocco
+	static const std::size_t block_size = ((sizeof(T) > sizeof(node_pool_detail::pool::block) ?
+		sizeof(T) : sizeof(node_pool_detail::pool::block)) + block_align - 1) / block_align * block_align;	///< Dimensione di un blocco, multipla dell'allineamento
+
+	static_assert(alignof(T) <= alignof(std::max_align_t), "node_pool_allocator: alignment not supported");
+
+	std::shared_ptr<node_pool_detail::pool_group> _group;	///< Gruppo di pool condiviso dalle copie e dalle conversioni
+	node_pool_detail::pool *_pool;	///< Pool del gruppo per i blocchi di tipo T
+
+public:
+	typedef T value_type;	///< Tipo degli oggetti allocati
+	typedef std::true_type propagate_on_container_swap;	///< Lo scambio di contenitori scambia anche i pool
+
+	/**
+		@brief Conversione verso un altro tipo
+
+		Struttura che definisce l'allocatore per oggetti di tipo U.
+	**/
+	template <typename U>
+	struct rebind{
+		typedef node_pool_allocator<U, MaxSlab> other;
+	};
+
+	/**
+		@brief Costruttore di default
+
+		Costruttore di default per istanziare un allocatore con un gruppo di pool vuoto.
+	**/
+	node_pool_allocator() : _group(new node_pool_detail::pool_group),
+		_pool(_group->find(block_size, MaxSlab)) {}
+
+	/**
+		@brief Costruttore secondario (CONVERSIONE)
+
+		Costruttore secondario. Crea un allocatore per T a partire da uno per U,
+		nello stesso gruppo di pool: i blocchi di T vengono presi dal pool della
+		loro dimensione, condiviso con gli altri tipi che hanno blocchi uguali.
+		@param other Allocatore sorgente.
+	**/
+	template <typename U>
+	node_pool_allocator(const node_pool_allocator<U, MaxSlab> &other) : _group(other._group),
+		_pool(_group->find(block_size, MaxSlab)) {}
+
+	/**
+		@brief Alloca memoria per n oggetti
+
+		@param n Numero di oggetti.
+		@return Il puntatore alla memoria allocata.
+	**/
+	T *allocate(std::size_t n){
+		if(n == 1)
+			return static_cast<T *>(_pool->take());
+		return static_cast<T *>(::operator new(n * sizeof(T)));
+	}
+
+	/**
+		@brief Dealloca memoria per n oggetti
+
+		@param p Puntatore alla memoria da deallocare.
+		@param n Numero di oggetti, uguale a quello passato ad allocate.
+	**/
+	void deallocate(T *p, std::size_t n){
+		if(n == 1)
+			_pool->give(p);
+		else
+			::operator delete(p);
+	}
+
+	/**
+		@brief Verifica che il pool non sia condiviso
+
+		@return true se nessun'altra copia o conversione dell'allocatore usa lo stesso gruppo di pool.
+	**/
+	bool unique(void) const{
+		return _group.use_count() == 1;
+	}
+
+	/**
+		@brief Libera in blocco tutta la memoria del gruppo di pool
+
+		Tutti gli oggetti allocati dal gruppo, di qualsiasi tipo, diventano invalidi.
+		@pre Gli oggetti allocati devono essere già stati distrutti.
+	**/
+	void release(void){
+		_group->release();
+	}
+
+	/**
+		@brief Allocatore per la copia di un contenitore
+
+		@return Un allocatore con un gruppo di pool nuovo, in modo che la copia
+		di un contenitore non condivida i pool con l'originale.
+	**/
+	node_pool_allocator select_on_container_copy_construction(void) const{
+		return node_pool_allocator();
+	}
+
+	/**
+		@brief Operatore di uguaglianza
+
+		@param other Allocatore con cui effettuare la comparazione.
+		@return true se i due allocatori condividono lo stesso gruppo di pool.
+	**/
+	template <typename U>
+	bool operator==(const node_pool_allocator<U, MaxSlab> &other) const{
+		return _group == other._group;
+	}
+
+	/**
+		@brief Operatore di diversità
+
+		@param other Allocatore con cui effettuare la comparazione.
+		@return true se i due allocatori non condividono lo stesso gruppo di pool.
+	**/
+	template <typename U>
+	bool operator!=(const node_pool_allocator<U, MaxSlab> &other) const{
+		return _group != other._group;
+	}
+};
+
+#endif
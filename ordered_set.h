@@ -0,0 +1,1102 @@
+#ifndef ORDERED_SET_H
+#define ORDERED_SET_H
+
+#include "set.h"	//already_existing_exception, not_existing_exception
+#include <ostream>	//operator <<
+#include <cstddef>	//ptrdiff_t
+#include <algorithm>	//lower_bound, upper_bound, swap
+#include <iterator>	//forward_iterator_tag
+#include <functional>	//less
+#include <memory>	//unique_ptr
+#include <new>	//placement new
+#include <optional>	//optional
+#include <type_traits>	//is_nothrow_move_constructible
+#include <vector>	//vector
+#include <cassert>	//assert
+
+/**
+	@file ordered_set.h
+	@brief Dichiarazione della classe ordered_set
+**/
+
+/**
+	@brief Set ordinato
+
+	Classe che rappresenta un set di elementi di tipo T mantenuti in ordine crescente
+	secondo il comparatore Less; due elementi sono considerati uguali se nessuno dei
+	due precede l'altro. Gli elementi sono memorizzati in un B+ tree: le foglie
+	contengono array contigui di elementi collegati tra loro, i nodi interni solo
+	le chiavi di separazione. Inserimento, rimozione e ricerca costano O(log N),
+	l'iterazione scorre le foglie in ordine.
+	Gli elementi vengono spostati tra i nodi, per cui T deve avere costruttore
+	e assegnamento per spostamento che non lanciano eccezioni.
+	@param T Tipo degli elementi.
+	@param Less Comparatore che definisce l'ordine, di default std::less<T>.
+**/
+template <typename T, typename Less = std::less<T> >
+class ordered_set{
+
+	static_assert(std::is_nothrow_move_constructible<T>::value &&
+		std::is_nothrow_move_assignable<T>::value, "ordered_set: T must be nothrow movable");
+
+	typedef std::size_t size_type;	///< Definzione del tipo corrispondente a size
+
+	static const unsigned int leaf_capacity = sizeof(T) * 4 >= 512 ? 4 : 512 / sizeof(T);	///< Elementi per foglia (circa 512 byte)
+	static const unsigned int leaf_min = leaf_capacity / 2;	///< Elementi minimi di una foglia diversa dalla radice
+	static const unsigned int inner_capacity = 32;	///< Chiavi per nodo interno
+	static const unsigned int inner_min = inner_capacity / 2;	///< Chiavi minime di un nodo interno diverso dalla radice
+	static const unsigned int max_height = 32;	///< Altezza massima dell'albero
+
+	/**
+		@brief Parte comune dei nodi
+
+		Per una foglia count è il numero di elementi, per un nodo interno
+		il numero di chiavi (i figli sono count + 1).
+	**/
+	struct node{
+		bool leaf;	///< Vero se il nodo è una foglia
+		unsigned int count;	///< Numero di elementi o di chiavi
+
+		explicit node(bool l) : leaf(l), count(0) {}
+	};
+
+	/**
+		@brief Foglia dell'albero
+
+		Gli elementi sono costruiti nelle prime count posizioni di storage.
+	**/
+	struct leaf_node : node{
+		leaf_node *prev;	///< Foglia precedente
+		leaf_node *next;	///< Foglia successiva
+		alignas(T) unsigned char storage[leaf_capacity * sizeof(T)];	///< Memoria per gli elementi
+
+		leaf_node() : node(true), prev(0), next(0) {}
+
+		T *values(void){
+			return reinterpret_cast<T *>(storage);
+		}
+
+		const T *values(void) const{
+			return reinterpret_cast<const T *>(storage);
+		}
+	};
+
+	/**
+		@brief Nodo interno dell'albero
+
+		Tutti gli elementi del figlio i precedono keys()[i], tutti
+		quelli del figlio i + 1 non la precedono.
+	**/
+	struct inner_node : node{
+		node *children[inner_capacity + 1];	///< Figli
+		alignas(T) unsigned char storage[inner_capacity * sizeof(T)];	///< Memoria per le chiavi
+
+		inner_node() : node(false) {}
+
+		T *keys(void){
+			return reinterpret_cast<T *>(storage);
+		}
+
+		const T *keys(void) const{
+			return reinterpret_cast<const T *>(storage);
+		}
+	};
+
+	/**
+		@brief Passo del percorso dalla radice ad una foglia
+	**/
+	struct step{
+		inner_node *n;	///< Nodo interno attraversato
+		unsigned int child;	///< Indice del figlio seguito
+	};
+
+	node *_root;	///< Radice dell'albero, 0 se il set è vuoto
+	size_type _size;	///< Numero di elementi
+	Less _less;	///< Comparatore
+
+	/**
+		@brief Sposta un oggetto in memoria non inizializzata
+
+		@param dst Memoria di destinazione, non inizializzata.
+		@param src Oggetto sorgente, che viene distrutto.
+	**/
+	static void relocate(T *dst, T *src){
+		new(dst) T(std::move(*src));
+		src->~T();
+	}
+
+	/**
+		@brief Inserisce un oggetto in un array
+
+		@param a Array di count oggetti.
+		@param count Numero di oggetti, incrementato.
+		@param pos Posizione di inserimento.
+		@param v Oggetto da spostare nell'array.
+	**/
+	static void insert_at(T *a, unsigned int &count, unsigned int pos, T &&v){
+		for(unsigned int k = count; k > pos; --k)
+			relocate(a + k, a + k - 1);
+		new(a + pos) T(std::move(v));
+		count++;
+	}
+
+	/**
+		@brief Rimuove un oggetto da un array
+
+		@param a Array di count oggetti.
+		@param count Numero di oggetti, decrementato.
+		@param pos Posizione dell'oggetto da distruggere.
+	**/
+	static void erase_at(T *a, unsigned int &count, unsigned int pos){
+		a[pos].~T();
+		for(unsigned int k = pos; k + 1 < count; ++k)
+			relocate(a + k, a + k + 1);
+		count--;
+	}
+
+	/**
+		@brief Distrugge un singolo nodo
+
+		Distrugge gli elementi o le chiavi del nodo, ma non i suoi figli.
+		@param n Nodo da distruggere.
+	**/
+	static void free_node(node *n){
+		if(n->leaf){
+			leaf_node *l = static_cast<leaf_node *>(n);
+			for(unsigned int k = 0; k < l->count; ++k)
+				l->values()[k].~T();
+			delete l;
+		}
+		else{
+			inner_node *in = static_cast<inner_node *>(n);
+			for(unsigned int k = 0; k < in->count; ++k)
+				in->keys()[k].~T();
+			delete in;
+		}
+	}
+
+	/**
+		@brief Distrugge un sottoalbero
+
+		@param n Radice del sottoalbero.
+	**/
+	static void destroy(node *n){
+		if(!n->leaf){
+			inner_node *in = static_cast<inner_node *>(n);
+			for(unsigned int k = 0; k <= in->count; ++k)
+				destroy(in->children[k]);
+		}
+		free_node(n);
+	}
+
+	/**
+		@brief Discesa dalla radice alla foglia di un valore
+
+		@pre Il set non deve essere vuoto.
+		@param v Valore cercato.
+		@param path Se non nullo, riceve i nodi interni attraversati.
+		@param depth Riceve il numero di nodi interni attraversati.
+		@return La foglia in cui si trova, o andrebbe inserito, il valore.
+	**/
+	leaf_node *find_leaf(const T &v, step *path, unsigned int &depth) const{
+
+		node *n = _root;
+		depth = 0;
+		while(!n->leaf){
+			inner_node *in = static_cast<inner_node *>(n);
+			unsigned int c = static_cast<unsigned int>(
+				std::upper_bound(in->keys(), in->keys() + in->count, v, _less) - in->keys());
+			if(path != 0)
+				path[depth] = step{in, c};
+			depth++;
+			n = in->children[c];
+		}
+		return static_cast<leaf_node *>(n);
+	}
+
+	/**
+		@brief Foglia più a sinistra
+
+		@return La prima foglia, oppure 0 se il set è vuoto.
+	**/
+	leaf_node *leftmost(void) const{
+
+		if(_root == 0)
+			return 0;
+
+		node *n = _root;
+		while(!n->leaf)
+			n = static_cast<inner_node *>(n)->children[0];
+		return static_cast<leaf_node *>(n);
+	}
+
+	/**
+		@brief Foglia più a destra
+
+		@return L'ultima foglia, oppure 0 se il set è vuoto.
+	**/
+	leaf_node *rightmost(void) const{
+
+		if(_root == 0)
+			return 0;
+
+		node *n = _root;
+		while(!n->leaf){
+			inner_node *in = static_cast<inner_node *>(n);
+			n = in->children[in->count];
+		}
+		return static_cast<leaf_node *>(n);
+	}
+
+	/**
+		@brief Costruisce l'albero da una sequenza ordinata
+
+		Le foglie vengono riempite in modo uniforme e i nodi interni costruiti dal basso.
+		In caso di eccezione tutti i nodi già costruiti vengono distrutti.
+		@pre Il set deve essere vuoto.
+		@param n Numero di elementi.
+		@param next Funtore che restituisce ad ogni chiamata il riferimento costante
+		all'elemento successivo della sequenza, in ordine crescente e senza duplicati.
+	**/
+	template <typename Next>
+	void build(size_type n, Next next){
+
+		if(n == 0)
+			return;
+
+		std::size_t leaves = (n + leaf_capacity - 1) / leaf_capacity;
+		std::vector<node *> built;
+		std::vector<node *> level;
+		std::vector<const T *> mins;
+		built.reserve(leaves * 2 + 1);
+		level.reserve(leaves);
+		mins.reserve(leaves);
+
+		try{
+			size_type done = 0;
+			leaf_node *prev = 0;
+			for(std::size_t k = 0; k < leaves; ++k){
+				size_type count = static_cast<size_type>((n - done) / (leaves - k));
+				leaf_node *l = new leaf_node;
+				built.push_back(l);
+				for(size_type i = 0; i < count; ++i){
+					new(l->values() + l->count) T(next());
+					l->count++;
+				}
+				done += count;
+
+				l->prev = prev;
+				if(prev != 0)
+					prev->next = l;
+				prev = l;
+				level.push_back(l);
+				mins.push_back(l->values());
+			}
+
+			while(level.size() > 1){
+				std::size_t parents = (level.size() + inner_capacity) / (inner_capacity + 1);
+				std::size_t used = 0, w = 0;
+				for(std::size_t k = 0; k < parents; ++k){
+					std::size_t count = (level.size() - used) / (parents - k);
+					inner_node *in = new inner_node;
+					built.push_back(in);
+					for(std::size_t c = 0; c < count; ++c){
+						in->children[c] = level[used + c];
+						if(c > 0){
+							new(in->keys() + in->count) T(*mins[used + c]);
+							in->count++;
+						}
+					}
+					level[w] = in;
+					mins[w] = mins[used];
+					w++;
+					used += count;
+				}
+				level.resize(w);
+				mins.resize(w);
+			}
+		}
+		catch(...){
+			for(std::size_t k = 0; k < built.size(); ++k)
+				free_node(built[k]);
+			throw;
+		}
+
+		_root = level[0];
+		_size = n;
+	}
+
+	/**
+		@brief Funzione di supporto per l'inserimento di un elemento
+
+		Tutte le operazioni che possono lanciare eccezioni (copia dell'elemento e della
+		chiave di separazione, allocazione dei nodi) vengono eseguite prima di modificare
+		l'albero, per cui in caso di eccezione il set resta invariato.
+		@param v Elemento da inserire.
+		@return true se l'elemento è stato inserito, false se era già presente.
+	**/
+	template <typename V>
+	bool add_value(V &&v){
+
+		T value(std::forward<V>(v));
+
+		if(_root == 0){
+			leaf_node *l = new leaf_node;
+			new(l->values()) T(std::move(value));
+			l->count = 1;
+			_root = l;
+			_size = 1;
+			return true;
+		}
+
+		step path[max_height];
+		unsigned int depth;
+		leaf_node *leaf = find_leaf(value, path, depth);
+		T *vals = leaf->values();
+		unsigned int pos = static_cast<unsigned int>(
+			std::lower_bound(vals, vals + leaf->count, value, _less) - vals);
+
+		if(pos < leaf->count && !_less(value, vals[pos]))
+			return false;
+
+		if(leaf->count < leaf_capacity){
+			insert_at(vals, leaf->count, pos, std::move(value));
+			_size++;
+			return true;
+		}
+
+		//la foglia è piena: la sequenza di leaf_capacity + 1 elementi viene divisa
+		//e il primo elemento della parte destra diventa la chiave di separazione
+		const unsigned int split = (leaf_capacity + 1) / 2;
+		T separator(split < pos ? vals[split] : (split == pos ? value : vals[split - 1]));
+
+		unsigned int full = 0;
+		while(full < depth && path[depth - 1 - full].n->count == inner_capacity)
+			full++;
+
+		std::unique_ptr<leaf_node> right_leaf(new leaf_node);
+		std::unique_ptr<inner_node> fresh[max_height + 1];
+		for(unsigned int k = 0; k < full + (full == depth ? 1 : 0); ++k)
+			fresh[k].reset(new inner_node);
+
+		leaf_node *r = right_leaf.release();
+		if(pos < split){
+			for(unsigned int k = split - 1; k < leaf_capacity; ++k)
+				relocate(r->values() + r->count++, vals + k);
+			leaf->count = split - 1;
+			insert_at(vals, leaf->count, pos, std::move(value));
+		}
+		else{
+			for(unsigned int k = split; k < leaf_capacity; ++k)
+				relocate(r->values() + r->count++, vals + k);
+			leaf->count = split;
+			insert_at(r->values(), r->count, pos - split, std::move(value));
+		}
+
+		r->prev = leaf;
+		r->next = leaf->next;
+		if(leaf->next != 0)
+			leaf->next->prev = r;
+		leaf->next = r;
+		_size++;
+
+		//risalita: separator e new_child vanno inseriti nel genitore
+		node *new_child = r;
+		unsigned int used = 0;
+		for(unsigned int level = depth; ; --level){
+
+			if(level == 0){
+				inner_node *root = fresh[used++].release();
+				new(root->keys()) T(std::move(separator));
+				root->count = 1;
+				root->children[0] = _root;
+				root->children[1] = new_child;
+				_root = root;
+				return true;
+			}
+
+			inner_node *p = path[level - 1].n;
+			unsigned int c = path[level - 1].child;
+
+			if(p->count < inner_capacity){
+				for(unsigned int k = p->count + 1; k > c + 1; --k)
+					p->children[k] = p->children[k - 1];
+				p->children[c + 1] = new_child;
+				insert_at(p->keys(), p->count, c, std::move(separator));
+				return true;
+			}
+
+			//nodo interno pieno: inner_capacity + 1 chiavi, quella centrale sale di livello
+			inner_node *q = fresh[used++].release();
+			alignas(T) unsigned char raw[(inner_capacity + 1) * sizeof(T)];
+			T *tk = reinterpret_cast<T *>(raw);
+			node *tc[inner_capacity + 2];
+
+			for(unsigned int k = 0, j = 0; k <= inner_capacity; ++k)
+				if(k == c)
+					new(tk + k) T(std::move(separator));
+				else
+					relocate(tk + k, p->keys() + j++);
+			for(unsigned int k = 0, j = 0; k <= inner_capacity + 1; ++k)
+				tc[k] = (k == c + 1) ? new_child : p->children[j++];
+
+			const unsigned int mid = (inner_capacity + 1) / 2;
+			for(unsigned int k = 0; k < mid; ++k){
+				relocate(p->keys() + k, tk + k);
+				p->children[k] = tc[k];
+			}
+			p->children[mid] = tc[mid];
+			p->count = mid;
+
+			separator = std::move(tk[mid]);
+			tk[mid].~T();
+
+			for(unsigned int k = mid + 1; k <= inner_capacity; ++k)
+				relocate(q->keys() + q->count++, tk + k);
+			for(unsigned int k = mid + 1; k <= inner_capacity + 1; ++k)
+				q->children[k - mid - 1] = tc[k];
+
+			new_child = q;
+		}
+	}
+
+	/**
+		@brief Ribilancia i nodi interni dopo una fusione
+
+		Risale il percorso a partire da level finché un nodo interno ha meno di
+		inner_min chiavi, prendendo in prestito una chiave da un fratello o
+		fondendosi con esso. Le chiavi vengono solo spostate, mai copiate.
+		@param path Percorso dalla radice.
+		@param level Livello del nodo che ha perso una chiave.
+	**/
+	void rebalance(step *path, unsigned int level){
+
+		for(;; --level){
+			inner_node *n = path[level].n;
+
+			if(level == 0){
+				if(n->count == 0){
+					_root = n->children[0];
+					free_node(n);
+				}
+				return;
+			}
+			if(n->count >= inner_min)
+				return;
+
+			inner_node *parent = path[level - 1].n;
+			unsigned int c = path[level - 1].child;
+			bool left = c > 0;
+			inner_node *sibling = static_cast<inner_node *>(parent->children[left ? c - 1 : c + 1]);
+			unsigned int key = left ? c - 1 : c;
+
+			if(sibling->count + n->count + 1 > inner_capacity){
+				//rotazione attraverso la chiave del genitore
+				if(left){
+					insert_at(n->keys(), n->count, 0, std::move(parent->keys()[key]));
+					for(unsigned int k = n->count; k > 0; --k)
+						n->children[k] = n->children[k - 1];
+					n->children[0] = sibling->children[sibling->count];
+					parent->keys()[key] = std::move(sibling->keys()[sibling->count - 1]);
+					sibling->keys()[sibling->count - 1].~T();
+					sibling->count--;
+				}
+				else{
+					new(n->keys() + n->count) T(std::move(parent->keys()[key]));
+					n->children[n->count + 1] = sibling->children[0];
+					n->count++;
+					parent->keys()[key] = std::move(sibling->keys()[0]);
+					erase_at(sibling->keys(), sibling->count, 0);
+					for(unsigned int k = 0; k <= sibling->count; ++k)
+						sibling->children[k] = sibling->children[k + 1];
+				}
+				return;
+			}
+
+			inner_node *l = left ? sibling : n;
+			inner_node *r = left ? n : sibling;
+			new(l->keys() + l->count) T(std::move(parent->keys()[key]));
+			l->count++;
+			for(unsigned int k = 0; k <= r->count; ++k)
+				l->children[l->count + k] = r->children[k];
+			for(unsigned int k = 0; k < r->count; ++k)
+				relocate(l->keys() + l->count + k, r->keys() + k);
+			l->count += r->count;
+			r->count = 0;
+			free_node(r);
+
+			erase_at(parent->keys(), parent->count, key);
+			for(unsigned int k = key + 1; k <= parent->count; ++k)
+				parent->children[k] = parent->children[k + 1];
+		}
+	}
+
+	/**
+		@brief Funzione di supporto per la rimozione di un elemento
+
+		L'unica operazione che può lanciare eccezioni, la copia della nuova chiave di
+		separazione quando una foglia prende in prestito un elemento, viene eseguita
+		prima di modificare l'albero.
+		@param v Elemento da rimuovere.
+		@return true se l'elemento è stato rimosso, false se non era presente.
+	**/
+	bool remove_value(const T &v){
+
+		if(_root == 0)
+			return false;
+
+		step path[max_height];
+		unsigned int depth;
+		leaf_node *leaf = find_leaf(v, path, depth);
+		T *vals = leaf->values();
+		unsigned int pos = static_cast<unsigned int>(
+			std::lower_bound(vals, vals + leaf->count, v, _less) - vals);
+
+		if(pos == leaf->count || _less(v, vals[pos]))
+			return false;
+
+		leaf_node *sibling = 0;
+		bool left = false;
+		std::optional<T> separator;
+		if(depth > 0 && leaf->count - 1 < leaf_min){
+			const step &s = path[depth - 1];
+			left = s.child > 0;
+			sibling = static_cast<leaf_node *>(s.n->children[left ? s.child - 1 : s.child + 1]);
+			if(sibling->count + leaf->count - 1 > leaf_capacity)
+				separator.emplace(left ? sibling->values()[sibling->count - 1] : sibling->values()[1]);
+		}
+
+		erase_at(vals, leaf->count, pos);
+		_size--;
+
+		if(depth == 0){
+			if(leaf->count == 0){
+				free_node(leaf);
+				_root = 0;
+			}
+			return true;
+		}
+		if(sibling == 0)
+			return true;
+
+		inner_node *parent = path[depth - 1].n;
+		unsigned int c = path[depth - 1].child;
+		T *sv = sibling->values();
+
+		if(separator){
+			if(left){
+				for(unsigned int k = leaf->count; k > 0; --k)
+					relocate(vals + k, vals + k - 1);
+				relocate(vals, sv + sibling->count - 1);
+				parent->keys()[c - 1] = std::move(*separator);
+			}
+			else{
+				relocate(vals + leaf->count, sv);
+				for(unsigned int k = 0; k + 1 < sibling->count; ++k)
+					relocate(sv + k, sv + k + 1);
+				parent->keys()[c] = std::move(*separator);
+			}
+			leaf->count++;
+			sibling->count--;
+			return true;
+		}
+
+		leaf_node *l = left ? sibling : leaf;
+		leaf_node *r = left ? leaf : sibling;
+		unsigned int key = left ? c - 1 : c;
+
+		for(unsigned int k = 0; k < r->count; ++k)
+			relocate(l->values() + l->count + k, r->values() + k);
+		l->count += r->count;
+		r->count = 0;
+		l->next = r->next;
+		if(r->next != 0)
+			r->next->prev = l;
+		free_node(r);
+
+		erase_at(parent->keys(), parent->count, key);
+		for(unsigned int k = key + 1; k <= parent->count; ++k)
+			parent->children[k] = parent->children[k + 1];
+
+		rebalance(path, depth - 1);
+		return true;
+	}
+
+	template <typename U, typename L, typename Pred>
+	friend ordered_set<U, L> filter_out(const ordered_set<U, L> &S, const Pred P);
+
+public:
+	/**
+		@brief Costruttore di default
+
+		Costruttore di default per istanziare un set vuoto.
+	**/
+	ordered_set() : _root(0), _size(0) {}
+
+	/**
+		@brief Costruttore secondario
+
+		Costruttore secondario. Permette di istanziare un set vuoto con un comparatore.
+		@param less Comparatore da utilizzare.
+	**/
+	explicit ordered_set(const Less &less) : _root(0), _size(0), _less(less) {}
+
+	/**
+		@brief Costruttore secondario (COSTRUTTORE DI COPIA)
+
+		Costruttore secondario. Permette di istanziare un set con valori presi
+		da un altro set. La copia è costruita direttamente dalla sequenza
+		ordinata, in O(N) e senza confronti.
+		@param other Set sorgente.
+	**/
+	ordered_set(const ordered_set &other) : _root(0), _size(0), _less(other._less) {
+		const_iterator i = other.begin();
+		build(other._size, [&i]() -> const T & { return *i++; });
+	}
+
+	/**
+		@brief Costruttore secondario (COSTRUTTORE DI SPOSTAMENTO)
+
+		Costruttore secondario. Sottrae l'albero ad un altro set, che resta vuoto.
+		@param other Set sorgente.
+	**/
+	ordered_set(ordered_set &&other) noexcept : _root(other._root), _size(other._size), _less(other._less) {
+		other._root = 0;
+		other._size = 0;
+	}
+
+	/**
+		@brief Operatore di assegnamento
+
+		Operatore di assegnamento. Permette la copia tra set.
+		@param other Set sorgente.
+		@return Riferimento a this.
+	**/
+	ordered_set &operator=(const ordered_set &other){
+		if(this != &other){
+			ordered_set tmp(other);
+			swap(tmp);
+		}
+		return *this;
+	}
+
+	/**
+		@brief Operatore di assegnamento per spostamento
+
+		@param other Set sorgente, che resta vuoto.
+		@return Riferimento a this.
+	**/
+	ordered_set &operator=(ordered_set &&other) noexcept{
+		if(this != &other){
+			clear_set();
+			swap(other);
+		}
+		return *this;
+	}
+
+	/**
+		@brief Distruttore
+
+		Distruttore della classe ordered_set.
+	**/
+	~ordered_set(){
+		clear_set();
+	}
+
+	/**
+		@brief Scambia il contenuto di due set
+
+		@param other Set con cui scambiare il contenuto.
+	**/
+	void swap(ordered_set &other) noexcept{
+		std::swap(_root, other._root);
+		std::swap(_size, other._size);
+		std::swap(_less, other._less);
+	}
+
+	/**
+		@brief Svuota il set
+
+		Distrugge tutti gli elementi del set.
+	**/
+	void clear_set(void){
+		if(_root != 0)
+			destroy(_root);
+		_root = 0;
+		_size = 0;
+	}
+
+	/**
+		@brief Aggiunge un elemento al set
+
+		@param v Elemento da aggiungere.
+		@throw already_existing_exception Eccezione che viene lanciata
+		se l'elemento è già presente nel set.
+	**/
+	void add(const T &v){
+		if(!add_value(v))
+			throw already_existing_exception();
+	}
+
+	/**
+		@brief Aggiunge un elemento al set (per spostamento)
+
+		@param v Elemento da aggiungere.
+		@throw already_existing_exception Eccezione che viene lanciata
+		se l'elemento è già presente nel set.
+	**/
+	void add(T &&v){
+		if(!add_value(std::move(v)))
+			throw already_existing_exception();
+	}
+
+	/**
+		@brief Aggiunge un elemento al set se non già presente
+
+		@param v Elemento da aggiungere.
+		@return true se l'elemento è stato aggiunto, false se era già presente.
+	**/
+	bool try_add(const T &v){
+		return add_value(v);
+	}
+
+	/**
+		@brief Aggiunge un elemento al set se non già presente (per spostamento)
+
+		@param v Elemento da aggiungere.
+		@return true se l'elemento è stato aggiunto, false se era già presente.
+	**/
+	bool try_add(T &&v){
+		return add_value(std::move(v));
+	}
+
+	/**
+		@brief Rimuove un elemento dal set
+
+		@param v Elemento da rimuovere.
+		@throw not_existing_exception Eccezione che viene lanciata
+		se l'elemento non è presente nel set.
+	**/
+	void remove(const T &v){
+		if(!remove_value(v))
+			throw not_existing_exception();
+	}
+
+	/**
+		@brief Rimuove un elemento dal set se presente
+
+		@param v Elemento da rimuovere.
+		@return true se l'elemento è stato rimosso, false se non era presente.
+	**/
+	bool try_remove(const T &v){
+		return remove_value(v);
+	}
+
+	/**
+		@brief Numero di elementi nel set
+
+		@return Il numero di elementi nel set.
+	**/
+	size_type size(void) const{
+		return _size;
+	}
+
+	/**
+		@brief Definizione della classe const_iterator
+
+		Classe che implementa iteratori di tipo costante utilizzabili nella classe
+		ordered_set. Gli elementi vengono visitati in ordine crescente.
+	**/
+	class const_iterator {
+		const leaf_node *l;
+		unsigned int i;
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef T                         value_type;
+		typedef ptrdiff_t                 difference_type;
+		typedef const T*                  pointer;
+		typedef const T&                  reference;
+
+		/**
+			@brief Costruttore di default
+
+			Costruttore di default per istanziare un const_iterator.
+		**/
+		const_iterator() : l(0), i(0){}
+
+		/**
+			@brief Costruttore secondario (COSTRUTTORE DI COPIA)
+
+			Costruttore secondario. Permette di creare un const_iterator
+			come copia di un altro const_iterator.
+			@param other Const_iterator sorgente.
+		**/
+		const_iterator(const const_iterator &other) : l(other.l), i(other.i){}
+
+		/**
+			@brief Operatore di assegnamento
+
+			Operatore di assegnamento. Permette la copia tra const_iterator.
+			@param other Const_iterator sorgente.
+			@return Riferimento a this.
+		**/
+		const_iterator& operator=(const const_iterator &other) {
+			l = other.l;
+			i = other.i;
+			return *this;
+		}
+
+		/**
+			@brief Distruttore
+
+			Distrugge il const_iterator al termine dell'utilizzo.
+		**/
+		~const_iterator() {}
+
+		/**
+			@brief Operatore di dereferenziamento
+
+			Operatore di dereferenziamento. Ritorna il dato riferito dall'iteratore.
+			@return Il dato riferito dall'iteratore.
+		**/
+		reference operator*() const {
+			return l->values()[i];
+		}
+
+		/**
+			@brief Operatore freccia
+
+			Operatore freccia. Ritorna il puntatore al dato riferito dall'iteratore
+			@return Il puntatore al dato riferito dall'iteratore
+		**/
+		pointer operator->() const {
+			return l->values() + i;
+		}
+
+		/**
+			@brief Operatore di iterazione post-incremento
+
+			Operatore di iterazione post-incremento. Incrementa il const_iteratore
+			ma ne ritorna la copia non iterata.
+			@return La copia del const_iterator.
+		**/
+		const_iterator operator++(int) {
+
+			const_iterator tmp(*this);
+			++(*this);
+			return tmp;
+		}
+
+		/**
+			@brief Operatore di iterazione pre-incremento
+
+			Operatore di iterazione pre-incremento. Incrementa il const_iteratore
+			ma ne ritorna il riferimento
+			@return Il riferimento al const_iterator.
+		**/
+		const_iterator& operator++() {
+			if(++i == l->count){
+				l = l->next;
+				i = 0;
+			}
+			return *this;
+		}
+
+		/**
+			@brief Operatore di uguaglianza
+
+			Operatore di uguaglianza. Esegue una comparazione tra due const_iterator,
+			se sono uguali restituisce true, altrimenti restituisce false.
+			@param other Il const_iterator con cui effettuare la comparazione.
+			@return Il risultato della comparazione di due const_iterator.
+		**/
+		bool operator==(const const_iterator &other) const {
+			return (l==other.l && i==other.i);
+		}
+
+		/**
+			@brief Operatore di diversità
+
+			Operatore di diversità. Esegue una comparazione tra due const_iterator,
+			se sono diversi restituisce true, altrimenti restituisce false.
+			@param other Il const_iterator con cui effettuare la comparazione.
+			@return Il risultato della comparazione di due const_iterator.
+		**/
+		bool operator!=(const const_iterator &other) const {
+			return !(*this == other);
+		}
+
+	private:
+
+		friend class ordered_set;
+		const_iterator(const leaf_node *ll, unsigned int ii) : l(ll), i(ii){
+			if(l != 0 && i == l->count){
+				l = l->next;
+				i = 0;
+			}
+		}
+	}; // classe const_iterator
+
+	/**
+		@brief Intervallo di elementi
+
+		Coppia di iteratori utilizzabile in un ciclo for su intervallo.
+	**/
+	struct range_type{
+		const_iterator first;	///< Primo elemento dell'intervallo
+		const_iterator last;	///< Elemento successivo all'ultimo dell'intervallo
+
+		const_iterator begin() const {
+			return first;
+		}
+
+		const_iterator end() const {
+			return last;
+		}
+	};
+
+	/**
+		@brief Iteratore all'inizio della sequenza di dati
+
+		@return L'iteratore all'inizio della sequenza di dati.
+	**/
+	const_iterator begin() const {
+		return const_iterator(leftmost(), 0);
+	}
+
+	/**
+		@brief Iteratore alla fine della sequenza di dati
+
+		@return L'iteratore alla fine della sequenza di dati.
+	**/
+	const_iterator end() const {
+		return const_iterator();
+	}
+
+	/**
+		@brief Primo elemento non minore di un valore
+
+		@param v Valore cercato.
+		@return L'iteratore al primo elemento che non precede v, oppure end().
+	**/
+	const_iterator lower_bound(const T &v) const{
+
+		if(_root == 0)
+			return end();
+
+		unsigned int depth;
+		const leaf_node *leaf = find_leaf(v, 0, depth);
+		const T *vals = leaf->values();
+		return const_iterator(leaf, static_cast<unsigned int>(
+			std::lower_bound(vals, vals + leaf->count, v, _less) - vals));
+	}
+
+	/**
+		@brief Primo elemento maggiore di un valore
+
+		@param v Valore cercato.
+		@return L'iteratore al primo elemento che segue v, oppure end().
+	**/
+	const_iterator upper_bound(const T &v) const{
+
+		if(_root == 0)
+			return end();
+
+		unsigned int depth;
+		const leaf_node *leaf = find_leaf(v, 0, depth);
+		const T *vals = leaf->values();
+		return const_iterator(leaf, static_cast<unsigned int>(
+			std::upper_bound(vals, vals + leaf->count, v, _less) - vals));
+	}
+
+	/**
+		@brief Elementi compresi in un intervallo
+
+		@param lo Estremo inferiore, incluso.
+		@param hi Estremo superiore, escluso.
+		@return L'intervallo degli elementi che non precedono lo e che precedono hi.
+	**/
+	range_type range(const T &lo, const T &hi) const{
+		if(!_less(lo, hi))
+			return range_type{end(), end()};
+		return range_type{lower_bound(lo), lower_bound(hi)};
+	}
+
+	/**
+		@brief Verifica la presenza di un elemento
+
+		@param v Elemento da cercare.
+		@return true se l'elemento è presente nel set.
+	**/
+	bool contains(const T &v) const{
+		const_iterator i = lower_bound(v);
+		return i != end() && !_less(v, *i);
+	}
+
+	/**
+		@brief Elemento minimo
+
+		@pre Il set non deve essere vuoto.
+		@return Il riferimento costante al primo elemento.
+	**/
+	const T &min(void) const{
+		assert(_size > 0);
+		return leftmost()->values()[0];
+	}
+
+	/**
+		@brief Elemento massimo
+
+		@pre Il set non deve essere vuoto.
+		@return Il riferimento costante all'ultimo elemento.
+	**/
+	const T &max(void) const{
+		assert(_size > 0);
+		const leaf_node *l = rightmost();
+		return l->values()[l->count - 1];
+	}
+};
+
+/**
+	@brief Operatore di stream
+
+	Permette di spedire su uno stream di output il contenuto del set ordinato.
+	@param os stream di output
+	@param data_set Set sorgente i cui elementi verranno spediti sullo stream.
+	@return Il riferimento allo stream di output.
+**/
+template <typename T, typename Less>
+std::ostream &operator<<(std::ostream &os, const ordered_set<T, Less> &data_set){
+
+	typename ordered_set<T, Less>::const_iterator i, ie;
+
+	for(i=data_set.begin(), ie=data_set.end(); i!=ie; ++i)
+		os << *i << " ";
+	return os;
+}
+
+/**
+	@brief Funzione globale filter_out
+
+	Funzione che restituisce un nuovo set ordinato contenente i soli elementi
+	di S che non soddisfano il predicato P. Gli elementi sono già ordinati e
+	distinti, per cui il risultato viene costruito in O(N) senza confronti.
+	@param S Set ordinato sorgente.
+	@param P Predicato da valutare.
+	@return Il nuovo set ordinato.
+**/
+template <typename T, typename Less, typename Pred>
+ordered_set<T, Less> filter_out(const ordered_set<T, Less> &S, const Pred P){
+
+	std::vector<const T *> kept;
+	for(typename ordered_set<T, Less>::const_iterator i = S.begin(), ie = S.end(); i != ie; ++i)
+		if(!P(*i))
+			kept.push_back(&*i);
+
+	ordered_set<T, Less> result(S._less);
+	std::size_t k = 0;
+	result.build(kept.size(), [&]() -> const T & { return *kept[k++]; });
+	return result;
+}
+
+#endif
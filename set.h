@@ -3,86 +3,2809 @@
 
 #include <ostream>	//operator <<
 #include <cstddef>	//ptrdiff_t
-#include <algorithm> //swap
+#include <algorithm> //swap, find, lower_bound
 #include <iterator>	//const_iterator
+#include <memory>	//allocator
+#include <new>	//placement new
 #include <cassert>	//assert
+#include <vector>	//vector
+#include <type_traits>	//is_same, conditional
+#include <cstdint>	//uint64_t
+#include <utility>	//declval
+#include <thread>	//thread
+#include <atomic>	//atomic
+#include <exception>	//exception_ptr
+#include <functional>	//equal_to
+#include <stdexcept>	//length_error
+#include <cstring>	//memcpy
+#include "set_stats.h"	//no_stats, set_stats
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>	//intrinseci SSE2/AVX2
+#endif
+
+/**
+	@file set.h 
+	@brief Dichiarazione della classe set
+**/
+
+/**
+	@brief Dichiarazione dell'eccezione already_existing_exception
+
+	L'eccezione viene lanciata quando si tenta di aggiungere in un set
+	un elemento già esistente (nel set stesso).
+**/
+class already_existing_exception{};
+
+/**
+	@brief Dichiarazione dell'eccezione not_existing_exception
+
+	L'eccezione viene lanciata quando si tenta di rimuovere un elemento
+	non esistente in un set.
+**/
+class not_existing_exception{};
+
+/**
+	@brief Funtore di hash nullo
+
+	Tipo da usare come parametro Hash del set per disabilitare l'indice hash.
+	Con no_hash la ricerca di un elemento avviene tramite scansione lineare
+	della lista (comportamento di default).
+**/
+struct no_hash{};
+
+namespace set_detail{
+
+/**
+	@brief Indice hash ad indirizzamento aperto
+
+	Tabella hash con probing lineare che associa l'hash di un valore all'handle
+	(es. il puntatore al nodo) dell'elemento corrispondente. La tabella non conosce
+	i valori: il confronto per uguaglianza viene delegato al chiamante.
+	La cancellazione avviene tramite backward shift, senza lapidi.
+**/
+template <typename Handle>
+class hash_index{
+
+	/**
+		@brief Singola cella della tabella
+
+		Una cella è vuota quando il suo handle è uguale all'handle nullo.
+	**/
+	struct slot{
+		std::size_t hash;	///< Hash del valore riferito dall'handle
+		Handle handle;	///< Handle dell'elemento
+	};
+
+	std::vector<slot> _slots;	///< Celle della tabella, in numero pari a una potenza di 2
+	std::size_t _count;	///< Numero di celle occupate
+	unsigned int _shift;	///< 64 - log2(numero di celle), usato per il fibonacci hashing
+	Handle _null;	///< Handle che identifica una cella vuota
+
+	/**
+		@brief Posizione iniziale di un hash nella tabella
+
+		Il fibonacci hashing distribuisce sulla tabella anche hash poco
+		casuali (es. std::hash<int>, che è l'identità).
+		@param hash Hash di cui calcolare la posizione.
+		@return L'indice della prima cella da ispezionare.
+	**/
+	std::size_t home(std::size_t hash) const{
+		return static_cast<std::size_t>(
+			(static_cast<std::uint64_t>(hash) * 11400714819323198485ull) >> _shift);
+	}
+
+	/**
+		@brief Ridimensiona la tabella
+
+		Alloca una nuova tabella di capacity celle e vi reinserisce tutti gli
+		handle usando l'hash memorizzato, senza ricalcolarlo.
+		@param capacity Nuovo numero di celle (potenza di 2).
+	**/
+	void rehash(std::size_t capacity){
+
+		slot empty = {0, _null};
+		std::vector<slot> old(capacity, empty);
+		old.swap(_slots);
+
+		_shift = 64;
+		for(std::size_t c = capacity; c > 1; c >>= 1)
+			_shift--;
+
+		std::size_t mask = capacity - 1;
+		for(std::size_t i = 0; i < old.size(); ++i)
+			if(old[i].handle != _null){
+				std::size_t j = home(old[i].hash);
+				while(_slots[j].handle != _null)
+					j = (j + 1) & mask;
+				_slots[j] = old[i];
+			}
+	}
+
+public:
+	/**
+		@brief Costruttore secondario
+
+		Costruttore secondario. Permette di istanziare un indice vuoto.
+		La tabella viene allocata solo al primo inserimento.
+		@param null Handle che identifica una cella vuota, di default Handle().
+	**/
+	explicit hash_index(Handle null = Handle()) : _count(0), _shift(64), _null(null) {}
+
+	/**
+		@brief Ricerca di un handle nell'indice
+
+		@param hash Hash del valore cercato.
+		@param match Predicato che, dato un handle candidato, verifica
+		se l'elemento riferito è uguale al valore cercato.
+		@return L'handle trovato, oppure l'handle nullo.
+	**/
+	template <typename Match>
+	Handle find(std::size_t hash, Match match) const{
+
+		if(_count == 0)
+			return _null;
+
+		std::size_t mask = _slots.size() - 1;
+		for(std::size_t i = home(hash); _slots[i].handle != _null; i = (i + 1) & mask)
+			if(_slots[i].hash == hash && match(_slots[i].handle))
+				return _slots[i].handle;
+
+		return _null;
+	}
+
+	/**
+		@brief Numero di handle nell'indice
+
+		@return Il numero di celle occupate.
+	**/
+	std::size_t size(void) const{
+		return _count;
+	}
+
+	/**
+		@brief Numero di celle della tabella
+
+		@return Il numero di celle allocate, 0 se la tabella non è ancora stata allocata.
+	**/
+	std::size_t capacity(void) const{
+		return _slots.size();
+	}
+
+	/**
+		@brief Predispone la tabella per n elementi
+
+		Garantisce che i successivi inserimenti, fino a n elementi totali,
+		non richiedano allocazioni.
+		@param n Numero di elementi da poter contenere.
+	**/
+	void reserve(std::size_t n){
+
+		std::size_t capacity = _slots.empty() ? 8 : _slots.size();
+		//fattore di carico massimo 0.7
+		while(n * 10 > capacity * 7)
+			capacity <<= 1;
+		if(capacity != _slots.size())
+			rehash(capacity);
+	}
+
+	/**
+		@brief Inserisce un handle nell'indice
+
+		@pre L'handle non deve essere già presente nell'indice.
+		@param hash Hash del valore riferito dall'handle.
+		@param h Handle da inserire.
+	**/
+	void insert(std::size_t hash, Handle h){
+
+		reserve(_count + 1);
+
+		std::size_t mask = _slots.size() - 1;
+		std::size_t i = home(hash);
+		while(_slots[i].handle != _null)
+			i = (i + 1) & mask;
+
+		_slots[i].hash = hash;
+		_slots[i].handle = h;
+		_count++;
+	}
+
+	/**
+		@brief Rimuove un handle dall'indice
+
+		Le celle successive appartenenti alla stessa sequenza di probing
+		vengono spostate all'indietro, in modo da non lasciare lapidi.
+		@pre L'handle deve essere presente nell'indice.
+		@param hash Hash del valore riferito dall'handle.
+		@param h Handle da rimuovere.
+	**/
+	void erase(std::size_t hash, Handle h){
+
+		std::size_t mask = _slots.size() - 1;
+		std::size_t i = home(hash);
+		while(_slots[i].handle != h)
+			i = (i + 1) & mask;
+
+		for(std::size_t j = (i + 1) & mask; _slots[j].handle != _null; j = (j + 1) & mask){
+			std::size_t k = home(_slots[j].hash);
+			//la cella j resta al suo posto se la sua posizione iniziale k è in (i, j]
+			bool stays = (i <= j) ? (i < k && k <= j) : (i < k || k <= j);
+			if(!stays){
+				_slots[i] = _slots[j];
+				i = j;
+			}
+		}
+		_slots[i].handle = _null;
+		_count--;
+	}
+
+	/**
+		@brief Svuota l'indice mantenendo la tabella
+
+		Rimuove tutti gli handle senza liberare la memoria della tabella, in modo
+		che il reinserimento dello stesso numero di handle non richieda allocazioni.
+	**/
+	void reset(void){
+		for(std::size_t i = 0; i < _slots.size(); ++i)
+			_slots[i].handle = _null;
+		_count = 0;
+	}
+
+	/**
+		@brief Svuota l'indice
+
+		Rimuove tutti gli handle e libera la memoria della tabella.
+	**/
+	void clear(void){
+		std::vector<slot>().swap(_slots);
+		_count = 0;
+		_shift = 64;
+	}
+
+	/**
+		@brief Scambia il contenuto di due indici
+
+		@param other Indice con cui scambiare il contenuto.
+	**/
+	void swap(hash_index &other) noexcept{
+		_slots.swap(other._slots);
+		std::swap(_count, other._count);
+		std::swap(_shift, other._shift);
+		std::swap(_null, other._null);
+	}
+};
+
+/**
+	@brief Verifica se un allocatore supporta il rilascio in blocco
+
+	Vale true se l'allocatore A dispone dei metodi unique() e release()
+	(come node_pool_allocator), false altrimenti.
+**/
+template <typename A, typename = void>
+struct has_bulk_release : std::false_type {};
+
+template <typename A>
+struct has_bulk_release<A, decltype(std::declval<A &>().release(), (void)std::declval<const A &>().unique())>
+	: std::true_type {};
+
+/**
+	@brief Indice assente
+
+	Segnaposto usato al posto di hash_index quando il set è istanziato con no_hash.
+**/
+struct no_index{
+	no_index() {}
+
+	template <typename Handle>
+	explicit no_index(Handle) {}
+};
+
+/**
+	@brief Verifica se un set può cercare i valori con istruzioni SIMD
+
+	Vale true se T è un tipo aritmetico di 1, 2, 4 o 8 byte ed Eql è l'uguaglianza
+	standard (std::equal_to<T> o std::equal_to<>), per cui confrontare due valori
+	equivale all'operatore == e non serve chiamare il funtore.
+**/
+template <typename T, typename Eql>
+struct simd_scannable : std::integral_constant<bool,
+	std::is_arithmetic<T>::value &&
+	(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8) &&
+	(std::is_same<Eql, std::equal_to<T> >::value || std::is_same<Eql, std::equal_to<> >::value)> {};
+
+/**
+	@brief Verifica se un funtore supporta la ricerca eterogenea
+
+	Vale true se F dichiara il tipo is_transparent, cioè accetta come argomento
+	anche chiavi di tipo diverso da quello degli elementi.
+**/
+template <typename F, typename = void>
+struct is_transparent : std::false_type {};
+
+template <typename F>
+struct is_transparent<F, std::void_t<typename F::is_transparent> > : std::true_type {};
+
+/**
+	@brief Verifica se un set supporta la ricerca eterogenea
+
+	Vale true se Eql è trasparente e Hash è trasparente oppure no_hash.
+**/
+template <typename Eql, typename Hash>
+struct transparent_lookup : std::integral_constant<bool,
+	is_transparent<Eql>::value && (std::is_same<Hash, no_hash>::value || is_transparent<Hash>::value)> {};
+
+/**
+	@brief Ricerca lineare di un valore in un array (versione scalare)
+
+	@param data Array da scandire.
+	@param n Numero di celle dell'array.
+	@param v Valore cercato.
+	@return La posizione della prima cella uguale a v, oppure n.
+**/
+template <typename T>
+std::size_t scan_scalar(const T *data, std::size_t n, T v){
+	for(std::size_t i = 0; i < n; ++i)
+		if(data[i] == v)
+			return i;
+	return n;
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+
+/**
+	@brief Ricerca lineare di un valore in un array (versione SSE2)
+
+	Confronta 16 byte per iterazione. SSE2 fa parte dell'architettura x86-64,
+	quindi non serve verificarne il supporto a runtime.
+	@param data Array da scandire.
+	@param n Numero di celle dell'array.
+	@param v Valore cercato.
+	@return La posizione della prima cella uguale a v, oppure n.
+**/
+template <typename T>
+__attribute__((target("sse2")))
+std::size_t scan_sse2(const T *data, std::size_t n, T v){
+
+	const std::size_t lanes = 16 / sizeof(T);
+	std::size_t i = 0;
+
+	if constexpr (std::is_same<T, float>::value){
+		__m128 key = _mm_set1_ps(v);
+		for(; i + lanes <= n; i += lanes){
+			int m = _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(data + i), key));
+			if(m != 0)
+				return i + __builtin_ctz(m);
+		}
+	}
+	else if constexpr (std::is_same<T, double>::value){
+		__m128d key = _mm_set1_pd(v);
+		for(; i + lanes <= n; i += lanes){
+			int m = _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(data + i), key));
+			if(m != 0)
+				return i + __builtin_ctz(m);
+		}
+	}
+	else{
+		__m128i key;
+		if constexpr (sizeof(T) == 1)
+			key = _mm_set1_epi8(static_cast<char>(v));
+		else if constexpr (sizeof(T) == 2)
+			key = _mm_set1_epi16(static_cast<short>(v));
+		else if constexpr (sizeof(T) == 4)
+			key = _mm_set1_epi32(static_cast<int>(v));
+		else
+			key = _mm_set1_epi64x(static_cast<long long>(v));
+
+		for(; i + lanes <= n; i += lanes){
+			__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+			unsigned int m;
+			if constexpr (sizeof(T) == 1)
+				m = _mm_movemask_epi8(_mm_cmpeq_epi8(x, key));
+			else if constexpr (sizeof(T) == 2)
+				m = _mm_movemask_epi8(_mm_cmpeq_epi16(x, key));
+			else if constexpr (sizeof(T) == 4)
+				m = _mm_movemask_epi8(_mm_cmpeq_epi32(x, key));
+			else{
+				//SSE2 non confronta interi a 64 bit: una cella è uguale se lo sono entrambe le metà
+				m = _mm_movemask_epi8(_mm_cmpeq_epi32(x, key));
+				m = ((m & 0x00ff) == 0x00ff ? 0x00ff : 0) | ((m & 0xff00) == 0xff00 ? 0xff00 : 0);
+			}
+			if(m != 0)
+				return i + __builtin_ctz(m) / sizeof(T);
+		}
+	}
+	return i + scan_scalar(data + i, n - i, v);
+}
+
+/**
+	@brief Ricerca lineare di un valore in un array (versione AVX2)
+
+	Confronta 32 byte per iterazione.
+	@pre Il processore deve supportare AVX2.
+	@param data Array da scandire.
+	@param n Numero di celle dell'array.
+	@param v Valore cercato.
+	@return La posizione della prima cella uguale a v, oppure n.
+**/
+template <typename T>
+__attribute__((target("avx2")))
+std::size_t scan_avx2(const T *data, std::size_t n, T v){
+
+	const std::size_t lanes = 32 / sizeof(T);
+	std::size_t i = 0;
+
+	if constexpr (std::is_same<T, float>::value){
+		__m256 key = _mm256_set1_ps(v);
+		for(; i + lanes <= n; i += lanes){
+			int m = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(data + i), key, _CMP_EQ_OQ));
+			if(m != 0)
+				return i + __builtin_ctz(m);
+		}
+	}
+	else if constexpr (std::is_same<T, double>::value){
+		__m256d key = _mm256_set1_pd(v);
+		for(; i + lanes <= n; i += lanes){
+			int m = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(data + i), key, _CMP_EQ_OQ));
+			if(m != 0)
+				return i + __builtin_ctz(m);
+		}
+	}
+	else{
+		__m256i key;
+		if constexpr (sizeof(T) == 1)
+			key = _mm256_set1_epi8(static_cast<char>(v));
+		else if constexpr (sizeof(T) == 2)
+			key = _mm256_set1_epi16(static_cast<short>(v));
+		else if constexpr (sizeof(T) == 4)
+			key = _mm256_set1_epi32(static_cast<int>(v));
+		else
+			key = _mm256_set1_epi64x(static_cast<long long>(v));
+
+		for(; i + lanes <= n; i += lanes){
+			__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+			unsigned int m;
+			if constexpr (sizeof(T) == 1)
+				m = _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, key));
+			else if constexpr (sizeof(T) == 2)
+				m = _mm256_movemask_epi8(_mm256_cmpeq_epi16(x, key));
+			else if constexpr (sizeof(T) == 4)
+				m = _mm256_movemask_epi8(_mm256_cmpeq_epi32(x, key));
+			else
+				m = _mm256_movemask_epi8(_mm256_cmpeq_epi64(x, key));
+			if(m != 0)
+				return i + __builtin_ctz(m) / sizeof(T);
+		}
+	}
+	return i + scan_scalar(data + i, n - i, v);
+}
+
+/**
+	@brief Supporto AVX2 del processore
+
+	@return true se il processore supporta AVX2; il controllo viene eseguito una sola volta.
+**/
+inline bool cpu_has_avx2(void){
+	static const bool avx2 = (__builtin_cpu_init(), __builtin_cpu_supports("avx2") != 0);
+	return avx2;
+}
+
+/**
+	@brief Ricerca lineare di un valore in un array
+
+	Sceglie a runtime la versione AVX2 se disponibile, altrimenti SSE2.
+	@param data Array da scandire.
+	@param n Numero di celle dell'array.
+	@param v Valore cercato.
+	@return La posizione della prima cella uguale a v, oppure n.
+**/
+template <typename T>
+std::size_t scan(const T *data, std::size_t n, T v){
+	return cpu_has_avx2() ? scan_avx2(data, n, v) : scan_sse2(data, n, v);
+}
+
+#else
+
+/**
+	@brief Ricerca lineare di un valore in un array
+
+	Architettura senza versione vettoriale: ricerca scalare.
+	@param data Array da scandire.
+	@param n Numero di celle dell'array.
+	@param v Valore cercato.
+	@return La posizione della prima cella uguale a v, oppure n.
+**/
+template <typename T>
+std::size_t scan(const T *data, std::size_t n, T v){
+	return scan_scalar(data, n, v);
+}
+
+#endif
+
+/**
+	@brief Accesso alle operazioni interne del set
+
+	Struttura amica del set che espone alle funzioni globali di questo file
+	le operazioni che non controllano l'unicità degli elementi.
+	Non fa parte dell'interfaccia pubblica del set.
+**/
+struct set_access;
+
+/**
+	@brief Contenitore della politica di strumentazione
+
+	Classe base del set che memorizza la politica Stats. Se la politica
+	è vuota (es. no_stats) non occupa memoria e stats_policy() ne
+	restituisce un'istanza temporanea.
+**/
+template <typename Stats, bool = std::is_empty<Stats>::value>
+class stats_holder;
+
+/**
+	@brief Contenitore di un funtore
+
+	Classe base che memorizza un funtore di tipo F. Se F è una classe vuota
+	(es. equal_int, std::hash<int>, no_hash) il funtore viene ereditato e,
+	grazie all'ottimizzazione della classe base vuota, non occupa memoria.
+	Tag distingue i contenitori di funtori diversi della stessa classe.
+**/
+template <typename F, int Tag, bool = std::is_empty<F>::value && !std::is_final<F>::value>
+class functor_holder{
+	F _functor;	///< Funtore
+
+protected:
+	functor_holder() : _functor() {}
+	explicit functor_holder(const F &f) : _functor(f) {}
+
+	F &functor(void){
+		return _functor;
+	}
+
+	const F &functor(void) const{
+		return _functor;
+	}
+};
+
+template <typename F, int Tag>
+class functor_holder<F, Tag, true> : private F{
+protected:
+	functor_holder() : F() {}
+	explicit functor_holder(const F &f) : F(f) {}
+
+	F &functor(void){
+		return *this;
+	}
+
+	const F &functor(void) const{
+		return *this;
+	}
+};
+
+template <typename Stats, bool>
+class stats_holder{
+	mutable Stats _stats;	///< Politica di strumentazione
+
+protected:
+	Stats &stats_policy(void) const{
+		return _stats;
+	}
+};
+
+template <typename Stats>
+class stats_holder<Stats, true>{
+protected:
+	Stats stats_policy(void) const{
+		return Stats();
+	}
+};
+
+} // namespace set_detail
+
+/**
+	@brief Politica di memorizzazione a lista doppiamente linkata
+
+	Politica di memorizzazione di default del set: ogni elemento è contenuto
+	in un nodo allocato singolarmente, collegato al precedente e al successivo.
+	Gli elementi non vengono mai spostati in memoria.
+**/
+struct list_storage{
+	template <typename T, typename Alloc>
+	class container;
+};
+
+/**
+	@brief Politica di memorizzazione contigua
+
+	Gli elementi sono memorizzati in ordine di inserimento in un unico array,
+	quindi l'iterazione scorre la memoria linearmente.
+	La rimozione lascia una lapide al posto dell'elemento; quando le lapidi
+	superano la metà delle celle l'array viene compattato, preservando l'ordine.
+**/
+struct vector_storage{
+	template <typename T, typename Alloc>
+	class container;
+};
+
+/**
+	@brief Politica di memorizzazione con buffer interno
+
+	I primi K elementi sono memorizzati in un array contenuto nell'oggetto set
+	stesso, quindi un set con al più K elementi non effettua allocazioni
+	(nemmeno per l'indice hash, che viene costruito solo oltre K elementi).
+	Oltre K elementi l'array viene spostato sullo heap e raddoppiato ad ogni
+	riallocazione. La rimozione sposta indietro gli elementi successivi, con
+	costo lineare: la politica è pensata per set piccoli.
+	@param K Numero di elementi memorizzati senza allocazioni.
+**/
+template <unsigned int K>
+struct small_storage{
+	static_assert(K > 0, "small_storage: K must be positive");
+
+	template <typename T, typename Alloc>
+	class container;
+};
+
+/**
+	@brief Politica di memorizzazione compatta a nodi indicizzati
+
+	Come list_storage gli elementi sono nodi di una lista doppiamente linkata, ma i
+	nodi sono celle di un unico array (un pool) e i collegamenti sono indici a 32 bit:
+	un nodo occupa sizeof(T) più 8 byte, senza puntatori e senza l'intestazione di
+	un'allocazione per elemento. Le celle liberate dalle rimozioni vengono riusate
+	dagli inserimenti successivi; la rimozione ha costo costante e non sposta gli
+	elementi, quindi non richiede di ricostruire l'indice hash. Quando l'array è pieno
+	viene raddoppiato spostando gli elementi: gli handle restano validi, i riferimenti
+	agli elementi no. Il set può contenere al più 2^32 - 1 elementi.
+	Memoria per elemento su una piattaforma a 64 bit con glibc e libstdc++, esclusi
+	l'indice hash e lo spazio non ancora usato dopo un raddoppio:
+	- int: 12 byte (list_storage 32, vector_storage 5);
+	- std::string corta (fino a 15 caratteri): 40 byte (list_storage 64, vector_storage 33);
+	- voce (tre std::string corte): 104 byte (list_storage 128, vector_storage 97).
+**/
+struct compact_storage{
+	template <typename T, typename Alloc>
+	class container;
+};
+
+/**
+	@brief Contenitore della politica list_storage
+
+	Lista doppiamente linkata di nodi. L'handle di un elemento è il puntatore al suo nodo.
+	I nodi sono allocati con l'allocatore Alloc convertito al tipo del nodo; se l'allocatore
+	supporta il rilascio in blocco (es. node_pool_allocator) e non è condiviso, lo svuotamento
+	della lista libera tutta la memoria in un'unica operazione.
+**/
+template <typename T, typename Alloc>
+class list_storage::container{
+
+	/**
+		@brief Singolo nodo della lista
+
+		Struttura che definisce il singolo elemento della lista doppiamente linkata.
+	**/
+	struct node{
+		T value;	///< Dato di tipo generico T
+		node *previous;	///< Puntatore all'elemento precedente della lista
+		node *next;	///< Puntatore all'elemento successivo della lista	
+
+		/**
+		@brief Costruttore secondario
+
+			Costruttore secondario. Permette di istanziare un nodo costruendone
+			il valore sul posto a partire dagli argomenti args.
+			@param prev Puntatore al nodo precedente.
+			@param args Argomenti del costruttore di T.
+		**/
+		template <typename... Args>
+		node(node *prev, Args&&... args) : 
+			value(std::forward<Args>(args)...), previous(prev), next(0) {}
+	};
+
+	typedef typename std::allocator_traits<Alloc>::template rebind_alloc<node> node_allocator;	///< Allocatore dei nodi
+	typedef std::allocator_traits<node_allocator> node_traits;	///< Interfaccia dell'allocatore dei nodi
+
+	node *_head;	///< Puntatore alla testa della lista di dati di tipo generico T
+	node *_tail;	///< Puntatore alla coda della lista di dati di tipo generico T
+	std::size_t _size;	///< Dimensione della lista
+	node_allocator _alloc;	///< Allocatore dei nodi
+
+	/**
+		@brief Distrugge e dealloca un nodo
+
+		@param n Nodo da distruggere.
+	**/
+	void delete_node(node *n){
+		node_traits::destroy(_alloc, n);
+		node_traits::deallocate(_alloc, n, 1);
+	}
+
+public:
+	typedef std::size_t size_type;	///< Definzione del tipo corrispondente a size
+	typedef node *handle;	///< Handle di un elemento: il puntatore al suo nodo
+
+	static const bool random_access = false;	///< La lista non consente l'accesso diretto per indice
+	static const unsigned int inline_capacity = 0;	///< Ogni elemento richiede un'allocazione
+
+	/**
+		@brief Costruttore di default
+
+		Costruttore di default per istanziare una lista vuota.
+	**/
+	container() : _head(0), _tail(0), _size(0) {}
+
+	/**
+		@brief Costruttore secondario (COSTRUTTORE DI SPOSTAMENTO)
+
+		Costruttore secondario. Acquisisce i nodi di other, che rimane vuota.
+		@param other Lista sorgente.
+	**/
+	container(container &&other) noexcept(std::is_nothrow_default_constructible<node_allocator>::value)
+		: _head(0), _tail(0), _size(0) {
+		swap(other);
+	}
+
+	container(const container &other) = delete;
+	container &operator=(const container &other) = delete;
+
+	/**
+		@brief Distruttore
+
+		Distruttore. Rimuove la memoria allocata dalla lista.
+	**/
+	~container(){
+		clear();
+	}
+
+	/**
+		@brief Handle nullo
+
+		@return L'handle che non riferisce alcun elemento.
+	**/
+	static handle null(void){
+		return 0;
+	}
+
+	/**
+		@brief Handle del primo elemento
+
+		@return L'handle della testa della lista, oppure l'handle nullo.
+	**/
+	handle first(void) const{
+		return _head;
+	}
+
+	/**
+		@brief Handle dell'ultimo elemento
+
+		@return L'handle della coda della lista, oppure l'handle nullo.
+	**/
+	handle last(void) const{
+		return _tail;
+	}
+
+	/**
+		@brief Predispone la memoria per n elementi
+
+		Per la lista non ha effetto: ogni nodo viene allocato singolarmente.
+		@param n Numero di elementi.
+	**/
+	void reserve(size_type n){
+		(void)n;
+	}
+
+	/**
+		@brief Handle dell'elemento successivo
+
+		@param h Handle di un elemento.
+		@return L'handle dell'elemento successivo, oppure l'handle nullo.
+	**/
+	handle next(handle h) const{
+		return h->next;
+	}
+
+	/**
+		@brief Valore di un elemento
+
+		@param h Handle di un elemento.
+		@return Il valore dell'elemento.
+	**/
+	const T &value(handle h) const{
+		return h->value;
+	}
+
+	/**
+		@brief Numero di elementi
+
+		@return Il numero di elementi della lista.
+	**/
+	size_type size(void) const{
+		return _size;
+	}
+
+	/**
+		@brief Verifica se il prossimo inserimento richiede un'allocazione
+
+		@return Sempre true: ogni elemento richiede un nuovo nodo.
+	**/
+	bool full(void) const{
+		return true;
+	}
+
+	/**
+		@brief Aggiunge un elemento in coda
+
+		Il valore viene costruito direttamente nel nuovo nodo.
+		@param args Argomenti del costruttore di T.
+		@return L'handle del nuovo elemento.
+	**/
+	template <typename... Args>
+	handle emplace_back(Args&&... args){
+
+		node *new_node = node_traits::allocate(_alloc, 1);
+		try{
+			node_traits::construct(_alloc, new_node, _tail, std::forward<Args>(args)...);
+		}catch(...){
+			node_traits::deallocate(_alloc, new_node, 1);
+			throw;
+		}
+
+		if(_head == 0)
+			//caso in cui la lista è vuota
+			_head = new_node;
+		else
+			_tail->next = new_node;
+		_tail = new_node;
+		_size++;
+		return new_node;
+	}
+
+	/**
+		@brief Rimuove un elemento
+
+		@param del_node Handle dell'elemento da rimuovere.
+		@return true se la rimozione ha spostato altri elementi in memoria,
+		invalidandone gli handle. Per la lista è sempre false.
+	**/
+	bool erase(handle del_node){
+
+		if(del_node == _head){
+			//l'elemento da cancellare è in testa
+			_head = del_node->next;
+			if(_head != 0)
+				//la lista è composta da almeno due elementi
+				_head->previous = 0;
+			else
+				//la lista è composta da un solo elemento
+				_tail = 0;
+		}
+		else{
+			//l'elemento da cancellare non è in testa
+			del_node->previous->next = del_node->next;
+			if(del_node->next != 0)
+				del_node->next->previous = del_node->previous;
+			else
+				_tail = del_node->previous;
+		}
+		delete_node(del_node);
+		_size--;
+		return false;
+	}
+
+	/**
+		@brief Rimuove gli elementi che soddisfano un predicato
+
+		Scorre la lista una sola volta ed elimina i nodi per cui pred è vero.
+		Il predicato viene chiamato prima della distruzione dell'elemento.
+		@param pred Predicato che riceve l'handle di un elemento.
+		@return Il numero di elementi rimossi.
+	**/
+	template <typename Pred>
+	size_type erase_if(Pred pred){
+
+		size_type removed = 0;
+		node *tmp = _head;
+
+		while(tmp != 0){
+			node *next = tmp->next;
+			if(pred(tmp)){
+				erase(tmp);
+				removed++;
+			}
+			tmp = next;
+		}
+		return removed;
+	}
+
+	/**
+		@brief Copia il contenuto di un'altra lista
+
+		Rende this una copia di other in un'unica passata: i valori vengono assegnati
+		ai nodi già esistenti, i nodi mancanti vengono aggiunti in coda e quelli in
+		eccesso vengono rimossi. Se T non è assegnabile per copia i nodi esistenti
+		vengono prima eliminati. In caso di eccezione la lista viene svuotata.
+		@param other Lista sorgente.
+	**/
+	void assign(const container &other){
+
+		node *dst = _head;
+		node *src = other._head;
+
+		if constexpr (!std::is_copy_assignable<T>::value){
+			clear();
+			dst = 0;
+		}
+
+		try{
+			//riutilizzo i nodi esistenti
+			for(; dst != 0 && src != 0; dst = dst->next, src = src->next)
+				dst->value = src->value;
+			//aggiungo i nodi mancanti
+			for(; src != 0; src = src->next)
+				emplace_back(src->value);
+		}catch(...){
+			clear();
+			throw;
+		}
+
+		//rimuovo i nodi in eccesso
+		while(dst != 0){
+			node *next = dst->next;
+			erase(dst);
+			dst = next;
+		}
+	}
+
+	/**
+		@brief Rimuove l'ultimo elemento
+
+		@pre La lista non deve essere vuota.
+	**/
+	void pop_back(void){
+		erase(_tail);
+	}
+
+	/**
+		@brief Svuota la lista
+
+		Metodo che itera sulla lista ed elimina tutti gli elementi liberando la memoria.
+		Con un allocatore a rilascio in blocco non condiviso i nodi vengono solo distrutti
+		(se T non è banalmente distruttibile) e la memoria viene liberata tutta insieme.
+	**/
+	void clear(void){
+
+		if constexpr (set_detail::has_bulk_release<node_allocator>::value){
+			if(_alloc.unique()){
+				if constexpr (!std::is_trivially_destructible<T>::value)
+					for(node *tmp = _head; tmp != 0; tmp = tmp->next)
+						node_traits::destroy(_alloc, tmp);
+				_alloc.release();
+				_head = 0;
+				_tail = 0;
+				_size = 0;
+				return;
+			}
+		}
+
+		node *tmp = _head;
+
+		while(tmp != 0){
+			node *next = tmp->next;
+			_head = next;
+			delete_node(tmp);
+			if(_head == 0)
+				_tail = 0;
+			_size--;
+			tmp = next;
+		}
+	}
+
+	/**
+		@brief Scambia il contenuto di due liste
+
+		@param other Lista con cui scambiare il contenuto.
+	**/
+	void swap(container &other) noexcept{
+		std::swap(_head, other._head);
+		std::swap(_tail, other._tail);
+		std::swap(_size, other._size);
+		std::swap(_alloc, other._alloc);
+	}
+};
+
+/**
+	@brief Contenitore della politica vector_storage
+
+	Array contiguo di elementi con lapidi. L'handle di un elemento è la sua
+	posizione nell'array; le celle rimosse restano non inizializzate fino
+	alla compattazione successiva. L'array è allocato con l'allocatore Alloc.
+**/
+template <typename T, typename Alloc>
+class vector_storage::container{
+
+public:
+	typedef std::size_t size_type;	///< Definzione del tipo corrispondente a size
+	typedef size_type handle;	///< Handle di un elemento: la sua posizione nell'array
+
+	static const bool random_access = true;	///< In assenza di lapidi l'array consente l'accesso diretto per indice
+	static const unsigned int inline_capacity = 0;	///< L'array è sempre allocato sullo heap
+
+private:
+	typedef typename std::allocator_traits<Alloc>::template rebind_alloc<T> allocator_type;	///< Allocatore dell'array
+	typedef std::allocator_traits<allocator_type> alloc_traits;	///< Interfaccia dell'allocatore dell'array
+
+	allocator_type _alloc;	///< Allocatore dell'array
+	T *_data;	///< Array degli elementi
+	size_type _capacity;	///< Numero di celle allocate
+	size_type _holes;	///< Numero di lapidi
+	std::vector<unsigned char> _live;	///< Per ogni cella usata: 1 se contiene un elemento, 0 se è una lapide
+
+	/**
+		@brief Prima cella occupata a partire da una posizione
+
+		@param h Posizione da cui iniziare la ricerca.
+		@return La posizione della prima cella occupata, oppure l'handle nullo.
+	**/
+	handle skip(handle h) const{
+
+		size_type end = static_cast<size_type>(_live.size());
+
+		while(h < end && !_live[h])
+			h++;
+		return h < end ? h : null();
+	}
+
+	/**
+		@brief Rialloca l'array
+
+		Sposta gli elementi in un nuovo array più capiente mantenendone la posizione,
+		quindi gli handle restano validi. In caso di eccezione l'array originale
+		non viene modificato.
+		Se T è banalmente copiabile l'intero array, lapidi comprese, viene copiato
+		con memcpy: le lapidi restano inizializzate e scan può leggerle.
+		@param capacity Nuovo numero di celle.
+	**/
+	void grow(size_type capacity){
+
+		T *data = alloc_traits::allocate(_alloc, capacity);
+		size_type i = 0;
+
+		if constexpr (std::is_trivially_copyable<T>::value){
+			try{
+				_live.reserve(capacity);
+			}catch(...){
+				alloc_traits::deallocate(_alloc, data, capacity);
+				throw;
+			}
+			if(_data != 0)
+				std::memcpy(static_cast<void *>(data), _data, _live.size() * sizeof(T));
+			destroy();
+			_data = data;
+			_capacity = capacity;
+			return;
+		}
+
+		try{
+			_live.reserve(capacity);
+			for(; i < _live.size(); ++i)
+				if(_live[i])
+					::new(static_cast<void *>(data + i)) T(std::move_if_noexcept(_data[i]));
+		}catch(...){
+			while(i-- > 0)
+				if(_live[i])
+					data[i].~T();
+			alloc_traits::deallocate(_alloc, data, capacity);
+			throw;
+		}
+
+		destroy();
+		_data = data;
+		_capacity = capacity;
+	}
+
+	/**
+		@brief Distrugge gli elementi e libera l'array
+
+		Le flag delle celle non vengono modificate.
+	**/
+	void destroy(void){
+
+		if(_data == 0)
+			return;
+		for(size_type i = 0; i < _live.size(); ++i)
+			if(_live[i])
+				_data[i].~T();
+		alloc_traits::deallocate(_alloc, _data, _capacity);
+		_data = 0;
+		_capacity = 0;
+	}
+
+	/**
+		@brief Compatta l'array
+
+		Sposta gli elementi verso l'inizio dell'array eliminando le lapidi,
+		senza modificarne l'ordine.
+	**/
+	void compact(void){
+
+		size_type w = 0;
+
+		for(size_type r = 0; r < _live.size(); ++r)
+			if(_live[r]){
+				if(r != w){
+					::new(static_cast<void *>(_data + w)) T(std::move(_data[r]));
+					_data[r].~T();
+				}
+				w++;
+			}
+		_live.assign(w, 1);
+		_holes = 0;
+	}
+
+	/**
+		@brief Ricalcola il numero di lapidi
+
+		Scarta le lapidi in coda e ricalcola il numero di quelle rimanenti.
+	**/
+	void recount(void){
+
+		while(!_live.empty() && !_live.back())
+			_live.pop_back();
+
+		_holes = 0;
+		for(size_type i = 0; i < _live.size(); ++i)
+			if(!_live[i])
+				_holes++;
+	}
+
+public:
+	/**
+		@brief Costruttore di default
+
+		Costruttore di default per istanziare un array vuoto.
+	**/
+	container() : _data(0), _capacity(0), _holes(0) {}
+
+	/**
+		@brief Costruttore secondario (COSTRUTTORE DI SPOSTAMENTO)
+
+		Costruttore secondario. Acquisisce l'array di other, che rimane vuoto.
+		@param other Array sorgente.
+	**/
+	container(container &&other) noexcept(std::is_nothrow_default_constructible<allocator_type>::value)
+		: _data(0), _capacity(0), _holes(0) {
+		swap(other);
+	}
+
+	container(const container &other) = delete;
+	container &operator=(const container &other) = delete;
+
+	/**
+		@brief Distruttore
+
+		Distruttore. Rimuove la memoria allocata dall'array.
+	**/
+	~container(){
+		clear();
+	}
+
+	/**
+		@brief Handle nullo
+
+		@return L'handle che non riferisce alcun elemento.
+	**/
+	static handle null(void){
+		return static_cast<handle>(-1);
+	}
+
+	/**
+		@brief Handle del primo elemento
+
+		@return La posizione del primo elemento, oppure l'handle nullo.
+	**/
+	handle first(void) const{
+		return skip(0);
+	}
+
+	/**
+		@brief Handle dell'ultimo elemento
+
+		Le lapidi in coda vengono sempre scartate, quindi l'ultima cella è occupata.
+		@return La posizione dell'ultimo elemento, oppure l'handle nullo.
+	**/
+	handle last(void) const{
+		return _live.empty() ? null() : static_cast<handle>(_live.size() - 1);
+	}
+
+	/**
+		@brief Predispone la memoria per n elementi
+
+		Garantisce che l'array possa contenere n celle senza riallocazioni.
+		@param n Numero di celle.
+	**/
+	void reserve(size_type n){
+		if(n > _capacity)
+			grow(n);
+	}
+
+	/**
+		@brief Handle dell'elemento successivo
+
+		@param h Handle di un elemento.
+		@return La posizione dell'elemento successivo, oppure l'handle nullo.
+	**/
+	handle next(handle h) const{
+		return skip(h + 1);
+	}
+
+	/**
+		@brief Valore di un elemento
+
+		@param h Handle di un elemento.
+		@return Il valore dell'elemento.
+	**/
+	const T &value(handle h) const{
+		return _data[h];
+	}
+
+	/**
+		@brief Verifica l'assenza di lapidi
+
+		@return true se l'array non contiene lapidi, quindi la posizione
+		di ogni elemento coincide con il suo indice nell'ordine di inserimento.
+	**/
+	bool dense(void) const{
+		return _holes == 0;
+	}
+
+	/**
+		@brief Accesso diretto ad un elemento
+
+		@pre E' necessario che dense() sia vero e che index < size.
+		@param index Indice dell'elemento.
+		@return Il valore dell'elemento in posizione index-esima.
+	**/
+	const T &at(size_type index) const{
+		return _data[index];
+	}
+
+	/**
+		@brief Ricerca vettoriale di un valore
+
+		Scandisce l'array con set_detail::scan. Le lapidi contengono ancora il valore
+		dell'elemento rimosso (anche dopo grow, che le copia), che può essere uguale
+		a quello cercato, per cui vengono saltate.
+		@pre T ed Eql devono soddisfare set_detail::simd_scannable.
+		@param v Valore cercato.
+		@param stop Posizione a cui fermare la scansione, oppure l'handle nullo.
+		@return La posizione dell'elemento, oppure l'handle nullo.
+	**/
+	handle scan(const T &v, handle stop) const{
+
+		std::size_t end = (stop == null()) ? _live.size() : stop;
+
+		for(std::size_t i = 0; ; ++i){
+			i += set_detail::scan(_data + i, end - i, v);
+			if(i >= end)
+				return null();
+			if(_live[i])
+				return static_cast<handle>(i);
+		}
+	}
+
+	/**
+		@brief Numero di elementi
+
+		@return Il numero di elementi dell'array, lapidi escluse.
+	**/
+	size_type size(void) const{
+		return static_cast<size_type>(_live.size()) - _holes;
+	}
+
+	/**
+		@brief Verifica se il prossimo inserimento richiede un'allocazione
+
+		@return true se tutte le celle allocate sono in uso.
+	**/
+	bool full(void) const{
+		return _live.size() == _capacity;
+	}
+
+	/**
+		@brief Aggiunge un elemento in coda
+
+		Il valore viene costruito direttamente nella prima cella libera.
+		@param args Argomenti del costruttore di T.
+		@return L'handle del nuovo elemento.
+	**/
+	template <typename... Args>
+	handle emplace_back(Args&&... args){
+
+		handle h = static_cast<handle>(_live.size());
+
+		if(h == _capacity)
+			grow(_capacity == 0 ? 8 : _capacity * 2);
+
+		alloc_traits::construct(_alloc, _data + h, std::forward<Args>(args)...);
+		_live.push_back(1);
+		return h;
+	}
+
+	/**
+		@brief Rimuove un elemento
+
+		L'elemento viene distrutto e la sua cella diventa una lapide.
+		Le lapidi in coda vengono scartate subito; se le lapidi superano la metà
+		delle celle l'array viene compattato. Se lo spostamento di T può lanciare
+		eccezioni la compattazione non avviene.
+		@param h Handle dell'elemento da rimuovere.
+		@return true se la rimozione ha compattato l'array, invalidando gli handle.
+	**/
+	bool erase(handle h){
+
+		_data[h].~T();
+		_live[h] = 0;
+		_holes++;
+
+		//le lapidi in coda vengono scartate
+		while(!_live.empty() && !_live.back()){
+			_live.pop_back();
+			_holes--;
+		}
+
+		if constexpr (std::is_nothrow_move_constructible<T>::value){
+			if(_holes > 8 && _holes * 2 > _live.size()){
+				compact();
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/**
+		@brief Rimuove gli elementi che soddisfano un predicato
+
+		Scorre l'array una sola volta, distrugge gli elementi per cui pred è vero
+		e compatta i rimanenti senza modificarne l'ordine (solo se lo spostamento
+		di T non può lanciare eccezioni, altrimenti lascia delle lapidi).
+		Il predicato viene chiamato prima della distruzione dell'elemento.
+		Gli handle degli elementi rimasti possono cambiare.
+		@param pred Predicato che riceve l'handle di un elemento.
+		@return Il numero di elementi rimossi.
+	**/
+	template <typename Pred>
+	size_type erase_if(Pred pred){
+
+		const bool movable = std::is_nothrow_move_constructible<T>::value;
+		size_type removed = 0;
+		size_type w = 0;
+		size_type r = 0;
+
+		try{
+			for(; r < _live.size(); ++r){
+				if(!_live[r])
+					continue;
+				if(pred(r)){
+					_data[r].~T();
+					_live[r] = 0;
+					removed++;
+				}
+				else if(movable){
+					if(r != w){
+						::new(static_cast<void *>(_data + w)) T(std::move(_data[r]));
+						_data[r].~T();
+						_live[r] = 0;
+						_live[w] = 1;
+					}
+					w++;
+				}
+			}
+		}catch(...){
+			//le celle già scandite sono compattate in [0, w), le altre sono invariate
+			recount();
+			throw;
+		}
+
+		if(movable)
+			_live.resize(w);
+		recount();
+		return removed;
+	}
+
+	/**
+		@brief Copia il contenuto di un altro array
+
+		Rende this una copia compatta (senza lapidi) di other in un'unica passata,
+		riutilizzando l'array già allocato se abbastanza capiente. Se T è
+		banalmente copiabile e other non ha lapidi l'array viene copiato con memcpy.
+		In caso di eccezione l'array viene svuotato.
+		@param other Array sorgente.
+	**/
+	void assign(const container &other){
+
+		//distruggo gli elementi mantenendo l'array
+		for(size_type i = 0; i < _live.size(); ++i)
+			if(_live[i])
+				_data[i].~T();
+		_live.clear();
+		_holes = 0;
+
+		try{
+			if(_capacity < other.size())
+				grow(other.size());
+
+			if constexpr (std::is_trivially_copyable<T>::value){
+				if(other._holes == 0){
+					//array senza lapidi: un'unica copia
+					if(other.size() > 0)
+						std::memcpy(static_cast<void *>(_data), other._data, other.size() * sizeof(T));
+					_live.assign(other.size(), 1);
+					return;
+				}
+			}
+
+			for(handle h = other.first(); h != null(); h = other.next(h)){
+				alloc_traits::construct(_alloc, _data + _live.size(), other._data[h]);
+				_live.push_back(1);
+			}
+		}catch(...){
+			clear();
+			throw;
+		}
+	}
+
+	/**
+		@brief Rimuove l'ultimo elemento
+
+		A differenza di erase non compatta mai l'array, quindi gli handle
+		degli altri elementi restano validi.
+		@pre L'array non deve essere vuoto.
+	**/
+	void pop_back(void){
+
+		_data[_live.size() - 1].~T();
+		_live.pop_back();
+
+		//le lapidi in coda vengono scartate
+		while(!_live.empty() && !_live.back()){
+			_live.pop_back();
+			_holes--;
+		}
+	}
+
+	/**
+		@brief Svuota l'array
+
+		Distrugge tutti gli elementi e libera la memoria.
+	**/
+	void clear(void){
+		destroy();
+		std::vector<unsigned char>().swap(_live);
+		_holes = 0;
+	}
+
+	/**
+		@brief Scambia il contenuto di due array
+
+		@param other Array con cui scambiare il contenuto.
+	**/
+	void swap(container &other) noexcept{
+		std::swap(_alloc, other._alloc);
+		std::swap(_data, other._data);
+		std::swap(_capacity, other._capacity);
+		std::swap(_holes, other._holes);
+		_live.swap(other._live);
+	}
+};
+
+/**
+	@brief Contenitore della politica small_storage
+
+	Array contiguo senza lapidi, inizialmente contenuto nel buffer interno di K celle.
+	L'handle di un elemento è la sua posizione nell'array. Gli elementi vengono
+	spostati in memoria alla riallocazione e alla rimozione di un elemento
+	precedente, per cui T deve avere un costruttore per spostamento che non lancia eccezioni.
+**/
+template <unsigned int K>
+template <typename T, typename Alloc>
+class small_storage<K>::container{
+
+	static_assert(std::is_nothrow_move_constructible<T>::value, "small_storage: T must be nothrow move constructible");
+
+public:
+	typedef std::size_t size_type;	///< Definzione del tipo corrispondente a size
+	typedef size_type handle;	///< Handle di un elemento: la sua posizione nell'array
+
+	static const bool random_access = true;	///< L'array non ha lapidi e consente l'accesso diretto per indice
+	static const unsigned int inline_capacity = K;	///< Numero di elementi memorizzati senza allocazioni
+
+private:
+	typedef typename std::allocator_traits<Alloc>::template rebind_alloc<T> allocator_type;	///< Allocatore dell'array sullo heap
+	typedef std::allocator_traits<allocator_type> alloc_traits;	///< Interfaccia dell'allocatore dell'array
+
+	allocator_type _alloc;	///< Allocatore dell'array sullo heap
+	T *_data;	///< Array degli elementi: il buffer interno oppure un array sullo heap
+	size_type _size;	///< Numero di elementi
+	size_type _capacity;	///< Numero di celle di _data
+	alignas(T) unsigned char _inline[K * sizeof(T)];	///< Buffer interno
+
+	/**
+		@brief Puntatore al buffer interno
+
+		@return Il puntatore alla prima cella del buffer interno.
+	**/
+	T *inline_data(void){
+		return reinterpret_cast<T *>(_inline);
+	}
+
+	/**
+		@brief Verifica se l'array è sullo heap
+
+		@return true se gli elementi non sono nel buffer interno.
+	**/
+	bool on_heap(void) const{
+		return _data != reinterpret_cast<const T *>(_inline);
+	}
+
+	/**
+		@brief Sposta un elemento in una cella non inizializzata
+
+		@param dst Cella di destinazione.
+		@param src Elemento sorgente, che viene distrutto.
+	**/
+	static void relocate(T *dst, T *src){
+		::new(static_cast<void *>(dst)) T(std::move(*src));
+		src->~T();
+	}
+
+	/**
+		@brief Rialloca l'array sullo heap
+
+		Sposta gli elementi in un nuovo array mantenendone la posizione.
+		In caso di eccezione l'array originale non viene modificato.
+		@param capacity Nuovo numero di celle.
+	**/
+	void grow(size_type capacity){
+
+		T *data = alloc_traits::allocate(_alloc, capacity);
+		for(size_type i = 0; i < _size; ++i)
+			relocate(data + i, _data + i);
+
+		if(on_heap())
+			alloc_traits::deallocate(_alloc, _data, _capacity);
+		_data = data;
+		_capacity = capacity;
+	}
+
+	/**
+		@brief Acquisisce il contenuto di un altro array
+
+		Un array sullo heap viene acquisito senza spostare gli elementi, un buffer
+		interno elemento per elemento. Gli allocatori vengono scambiati.
+		@pre this deve essere vuoto e senza array sullo heap.
+		@param other Array sorgente, che rimane vuoto.
+	**/
+	void take(container &other){
+
+		std::swap(_alloc, other._alloc);
+		if(other.on_heap()){
+			_data = other._data;
+			_capacity = other._capacity;
+		}
+		else
+			for(size_type i = 0; i < other._size; ++i)
+				relocate(_data + i, other._data + i);
+		_size = other._size;
+
+		other._data = other.inline_data();
+		other._capacity = K;
+		other._size = 0;
+	}
+
+public:
+	/**
+		@brief Costruttore di default
+
+		Costruttore di default per istanziare un array vuoto.
+	**/
+	container() : _data(inline_data()), _size(0), _capacity(K) {}
+
+	/**
+		@brief Costruttore secondario (COSTRUTTORE DI SPOSTAMENTO)
+
+		Costruttore secondario. Acquisisce gli elementi di other, che rimane vuoto.
+		@param other Array sorgente.
+	**/
+	container(container &&other) noexcept(std::is_nothrow_default_constructible<allocator_type>::value)
+		: _data(inline_data()), _size(0), _capacity(K) {
+		take(other);
+	}
+
+	container(const container &other) = delete;
+	container &operator=(const container &other) = delete;
+
+	/**
+		@brief Distruttore
+
+		Distruttore. Rimuove la memoria allocata dall'array.
+	**/
+	~container(){
+		clear();
+	}
+
+	/**
+		@brief Handle nullo
+
+		@return L'handle che non riferisce alcun elemento.
+	**/
+	static handle null(void){
+		return static_cast<handle>(-1);
+	}
+
+	/**
+		@brief Handle del primo elemento
+
+		@return La posizione del primo elemento, oppure l'handle nullo.
+	**/
+	handle first(void) const{
+		return _size == 0 ? null() : 0;
+	}
+
+	/**
+		@brief Handle dell'ultimo elemento
+
+		@return La posizione dell'ultimo elemento, oppure l'handle nullo.
+	**/
+	handle last(void) const{
+		return _size == 0 ? null() : _size - 1;
+	}
+
+	/**
+		@brief Predispone la memoria per n elementi
+
+		Garantisce che l'array possa contenere n celle senza riallocazioni.
+		@param n Numero di celle.
+	**/
+	void reserve(size_type n){
+		if(n > _capacity)
+			grow(n);
+	}
+
+	/**
+		@brief Handle dell'elemento successivo
+
+		@param h Handle di un elemento.
+		@return La posizione dell'elemento successivo, oppure l'handle nullo.
+	**/
+	handle next(handle h) const{
+		return h + 1 < _size ? h + 1 : null();
+	}
+
+	/**
+		@brief Valore di un elemento
+
+		@param h Handle di un elemento.
+		@return Il valore dell'elemento.
+	**/
+	const T &value(handle h) const{
+		return _data[h];
+	}
+
+	/**
+		@brief Verifica l'assenza di lapidi
+
+		@return Sempre true: la rimozione compatta subito l'array.
+	**/
+	bool dense(void) const{
+		return true;
+	}
+
+	/**
+		@brief Accesso diretto ad un elemento
+
+		@pre index < size.
+		@param index Indice dell'elemento.
+		@return Il valore dell'elemento in posizione index-esima.
+	**/
+	const T &at(size_type index) const{
+		return _data[index];
+	}
+
+	/**
+		@brief Ricerca vettoriale di un valore
+
+		@pre T ed Eql devono soddisfare set_detail::simd_scannable.
+		@param v Valore cercato.
+		@param stop Posizione a cui fermare la scansione, oppure l'handle nullo.
+		@return La posizione dell'elemento, oppure l'handle nullo.
+	**/
+	handle scan(const T &v, handle stop) const{
+
+		std::size_t end = (stop == null()) ? _size : stop;
+		std::size_t i = set_detail::scan(_data, end, v);
+		return i < end ? static_cast<handle>(i) : null();
+	}
+
+	/**
+		@brief Numero di elementi
+
+		@return Il numero di elementi dell'array.
+	**/
+	size_type size(void) const{
+		return _size;
+	}
+
+	/**
+		@brief Verifica se il prossimo inserimento richiede un'allocazione
+
+		@return true se tutte le celle (interne o sullo heap) sono in uso.
+	**/
+	bool full(void) const{
+		return _size == _capacity;
+	}
+
+	/**
+		@brief Aggiunge un elemento in coda
+
+		Il valore viene costruito direttamente nella prima cella libera;
+		superate le K celle del buffer interno l'array viene spostato sullo heap.
+		@param args Argomenti del costruttore di T.
+		@return L'handle del nuovo elemento.
+	**/
+	template <typename... Args>
+	handle emplace_back(Args&&... args){
+
+		if(_size == _capacity)
+			grow(_capacity * 2);
+
+		alloc_traits::construct(_alloc, _data + _size, std::forward<Args>(args)...);
+		return _size++;
+	}
+
+	/**
+		@brief Rimuove un elemento
+
+		L'elemento viene distrutto e gli elementi successivi vengono spostati
+		indietro di una posizione, preservando l'ordine.
+		@param h Handle dell'elemento da rimuovere.
+		@return true se sono stati spostati degli elementi, invalidandone gli handle.
+	**/
+	bool erase(handle h){
+
+		_data[h].~T();
+		for(size_type i = h; i + 1 < _size; ++i)
+			relocate(_data + i, _data + i + 1);
+		_size--;
+		return h != _size;
+	}
+
+	/**
+		@brief Rimuove gli elementi che soddisfano un predicato
+
+		Scorre l'array una sola volta, distrugge gli elementi per cui pred è vero
+		e compatta i rimanenti senza modificarne l'ordine. Il predicato viene
+		chiamato prima della distruzione dell'elemento.
+		@param pred Predicato che riceve l'handle di un elemento.
+		@return Il numero di elementi rimossi.
+	**/
+	template <typename Pred>
+	size_type erase_if(Pred pred){
+
+		size_type w = 0;
+		size_type r = 0;
+
+		try{
+			for(; r < _size; ++r){
+				if(pred(r))
+					_data[r].~T();
+				else{
+					if(r != w)
+						relocate(_data + w, _data + r);
+					w++;
+				}
+			}
+		}catch(...){
+			//gli elementi non ancora scanditi vengono accodati a quelli compattati
+			for(; r < _size; ++r, ++w)
+				if(r != w)
+					relocate(_data + w, _data + r);
+			_size = w;
+			throw;
+		}
+
+		size_type removed = _size - w;
+		_size = w;
+		return removed;
+	}
+
+	/**
+		@brief Copia il contenuto di un altro array
+
+		Riutilizza la memoria già disponibile se abbastanza capiente.
+		Se T è banalmente copiabile gli elementi vengono copiati con memcpy.
+		In caso di eccezione l'array viene svuotato.
+		@param other Array sorgente.
+	**/
+	void assign(const container &other){
+
+		for(size_type i = 0; i < _size; ++i)
+			_data[i].~T();
+		_size = 0;
+
+		try{
+			reserve(other._size);
+			if constexpr (std::is_trivially_copyable<T>::value){
+				if(other._size > 0)
+					std::memcpy(static_cast<void *>(_data), other._data, other._size * sizeof(T));
+				_size = other._size;
+				return;
+			}
+			for(; _size < other._size; ++_size)
+				alloc_traits::construct(_alloc, _data + _size, other._data[_size]);
+		}catch(...){
+			clear();
+			throw;
+		}
+	}
+
+	/**
+		@brief Rimuove l'ultimo elemento
+
+		Gli handle degli altri elementi restano validi.
+		@pre L'array non deve essere vuoto.
+	**/
+	void pop_back(void){
+		_data[--_size].~T();
+	}
+
+	/**
+		@brief Svuota l'array
+
+		Distrugge tutti gli elementi e libera la memoria sullo heap,
+		tornando al buffer interno.
+	**/
+	void clear(void){
+
+		for(size_type i = 0; i < _size; ++i)
+			_data[i].~T();
+		_size = 0;
+
+		if(on_heap()){
+			alloc_traits::deallocate(_alloc, _data, _capacity);
+			_data = inline_data();
+			_capacity = K;
+		}
+	}
+
+	/**
+		@brief Scambia il contenuto di due array
+
+		Gli elementi contenuti nei buffer interni vengono spostati.
+		@param other Array con cui scambiare il contenuto.
+	**/
+	void swap(container &other) noexcept(std::is_nothrow_default_constructible<allocator_type>::value){
+
+		container tmp;
+		tmp.take(*this);
+		take(other);
+		other.take(tmp);
+	}
+};
+
+/**
+	@brief Contenitore della politica compact_storage
+
+	Lista doppiamente linkata i cui nodi sono celle di un array allocato con
+	l'allocatore Alloc. L'handle di un elemento è la posizione del suo nodo;
+	le celle libere formano una lista collegata tramite il campo next.
+**/
+template <typename T, typename Alloc>
+class compact_storage::container{
+
+public:
+	typedef std::size_t size_type;	///< Definzione del tipo corrispondente a size
+	typedef std::uint32_t handle;	///< Handle di un elemento: la posizione del suo nodo
+
+	static const bool random_access = false;	///< L'ordine della lista non corrisponde alle posizioni
+	static const unsigned int inline_capacity = 0;	///< L'array è sempre allocato sullo heap
+
+private:
+	/**
+		@brief Singolo nodo della lista
+
+		Il valore viene costruito sul posto solo nelle celle in uso.
+	**/
+	struct node{
+		alignas(T) unsigned char value[sizeof(T)];	///< Memoria del dato di tipo generico T
+		handle previous;	///< Posizione dell'elemento precedente
+		handle next;	///< Posizione dell'elemento successivo, o della cella libera successiva
+	};
+
+	typedef typename std::allocator_traits<Alloc>::template rebind_alloc<node> node_allocator;	///< Allocatore dell'array
+	typedef std::allocator_traits<node_allocator> node_traits;	///< Interfaccia dell'allocatore dell'array
+
+	static const size_type max_cells = 0xffffffffu;	///< Numero massimo di celle: l'ultimo indice è l'handle nullo
+
+	node *_nodes;	///< Array dei nodi
+	size_type _capacity;	///< Numero di celle allocate
+	size_type _used;	///< Numero di celle usate almeno una volta
+	size_type _size;	///< Numero di elementi
+	handle _head;	///< Posizione della testa della lista
+	handle _tail;	///< Posizione della coda della lista
+	handle _free;	///< Prima cella libera tra quelle già usate
+	node_allocator _alloc;	///< Allocatore dell'array
+
+	/**
+		@brief Puntatore al valore di una cella
+
+		@param nodes Array dei nodi.
+		@param h Posizione della cella.
+		@return Il puntatore al valore contenuto nella cella.
+	**/
+	static T *slot(node *nodes, handle h){
+		return std::launder(reinterpret_cast<T *>(nodes[h].value));
+	}
+
+	/**
+		@brief Rialloca l'array
+
+		Sposta gli elementi in un nuovo array mantenendone la posizione,
+		quindi gli handle restano validi. In caso di eccezione l'array originale
+		non viene modificato.
+		@param capacity Nuovo numero di celle.
+	**/
+	void grow(size_type capacity){
+
+		node *nodes = node_traits::allocate(_alloc, capacity);
+		handle h = _head;
+
+		try{
+			for(; h != null(); h = _nodes[h].next)
+				::new(static_cast<void *>(nodes[h].value)) T(std::move_if_noexcept(*slot(_nodes, h)));
+		}catch(...){
+			for(handle k = _head; k != h; k = _nodes[k].next)
+				slot(nodes, k)->~T();
+			node_traits::deallocate(_alloc, nodes, capacity);
+			throw;
+		}
+
+		for(size_type i = 0; i < _used; ++i){
+			nodes[i].previous = _nodes[i].previous;
+			nodes[i].next = _nodes[i].next;
+		}
+
+		if(_nodes != 0){
+			destroy_values();
+			node_traits::deallocate(_alloc, _nodes, _capacity);
+		}
+		_nodes = nodes;
+		_capacity = capacity;
+	}
+
+	/**
+		@brief Distrugge gli elementi
+
+		I collegamenti non vengono modificati.
+	**/
+	void destroy_values(void){
+		if constexpr (!std::is_trivially_destructible<T>::value)
+			for(handle h = _head; h != null(); h = _nodes[h].next)
+				slot(_nodes, h)->~T();
+	}
+
+	/**
+		@brief Svuota la lista mantenendo l'array
+
+		Distrugge gli elementi e rende libere tutte le celle.
+	**/
+	void reset(void){
+		destroy_values();
+		_used = 0;
+		_size = 0;
+		_head = null();
+		_tail = null();
+		_free = null();
+	}
+
+public:
+	/**
+		@brief Costruttore di default
+
+		Costruttore di default per istanziare una lista vuota.
+	**/
+	container() : _nodes(0), _capacity(0), _used(0), _size(0),
+		_head(null()), _tail(null()), _free(null()) {}
+
+	/**
+		@brief Costruttore secondario (COSTRUTTORE DI SPOSTAMENTO)
+
+		Costruttore secondario. Acquisisce l'array di other, che rimane vuoto.
+		@param other Lista sorgente.
+	**/
+	container(container &&other) noexcept(std::is_nothrow_default_constructible<node_allocator>::value)
+		: _nodes(0), _capacity(0), _used(0), _size(0),
+		_head(null()), _tail(null()), _free(null()) {
+		swap(other);
+	}
+
+	container(const container &other) = delete;
+	container &operator=(const container &other) = delete;
+
+	/**
+		@brief Distruttore
+
+		Distruttore. Rimuove la memoria allocata dalla lista.
+	**/
+	~container(){
+		clear();
+	}
+
+	/**
+		@brief Handle nullo
+
+		@return L'handle che non riferisce alcun elemento.
+	**/
+	static handle null(void){
+		return static_cast<handle>(-1);
+	}
+
+	/**
+		@brief Handle del primo elemento
+
+		@return L'handle della testa della lista, oppure l'handle nullo.
+	**/
+	handle first(void) const{
+		return _head;
+	}
+
+	/**
+		@brief Handle dell'ultimo elemento
+
+		@return L'handle della coda della lista, oppure l'handle nullo.
+	**/
+	handle last(void) const{
+		return _tail;
+	}
+
+	/**
+		@brief Predispone la memoria per n elementi
+
+		@param n Numero di elementi da poter contenere senza riallocazioni.
+		@throw std::length_error Se n supera il numero massimo di elementi.
+	**/
+	void reserve(size_type n){
+		if(n > max_cells)
+			throw std::length_error("compact_storage: too many elements");
+		if(n > _capacity)
+			grow(n);
+	}
+
+	/**
+		@brief Handle dell'elemento successivo
+
+		@param h Handle di un elemento.
+		@return L'handle dell'elemento successivo, oppure l'handle nullo.
+	**/
+	handle next(handle h) const{
+		return _nodes[h].next;
+	}
+
+	/**
+		@brief Valore di un elemento
+
+		@param h Handle di un elemento.
+		@return Il valore dell'elemento.
+	**/
+	const T &value(handle h) const{
+		return *slot(_nodes, h);
+	}
+
+	/**
+		@brief Numero di elementi
+
+		@return Il numero di elementi della lista.
+	**/
+	size_type size(void) const{
+		return _size;
+	}
+
+	/**
+		@brief Verifica se il prossimo inserimento richiede un'allocazione
+
+		@return true se non ci sono celle libere.
+	**/
+	bool full(void) const{
+		return _free == null() && _used == _capacity;
+	}
+
+	/**
+		@brief Aggiunge un elemento in coda
+
+		Il valore viene costruito direttamente nella prima cella libera.
+		@param args Argomenti del costruttore di T.
+		@return L'handle del nuovo elemento.
+		@throw std::length_error Se la lista contiene già il numero massimo di elementi.
+	**/
+	template <typename... Args>
+	handle emplace_back(Args&&... args){
+
+		handle h = _free;
+
+		if(h == null()){
+			if(_used == _capacity){
+				if(_capacity == max_cells)
+					throw std::length_error("compact_storage: too many elements");
+				grow(_capacity == 0 ? 8 : _capacity > max_cells / 2 ? max_cells : _capacity * 2);
+			}
+			h = static_cast<handle>(_used);
+		}
+
+		::new(static_cast<void *>(_nodes[h].value)) T(std::forward<Args>(args)...);
+
+		if(h == _free)
+			_free = _nodes[h].next;
+		else
+			_used++;
+
+		_nodes[h].previous = _tail;
+		_nodes[h].next = null();
+		if(_tail == null())
+			//caso in cui la lista è vuota
+			_head = h;
+		else
+			_nodes[_tail].next = h;
+		_tail = h;
+		_size++;
+		return h;
+	}
+
+	/**
+		@brief Rimuove un elemento
+
+		La cella dell'elemento diventa la prima cella libera.
+		@param h Handle dell'elemento da rimuovere.
+		@return true se la rimozione ha spostato altri elementi in memoria,
+		invalidandone gli handle. Per questa lista è sempre false.
+	**/
+	bool erase(handle h){
+
+		node &del_node = _nodes[h];
+
+		if(del_node.previous == null())
+			_head = del_node.next;
+		else
+			_nodes[del_node.previous].next = del_node.next;
+
+		if(del_node.next == null())
+			_tail = del_node.previous;
+		else
+			_nodes[del_node.next].previous = del_node.previous;
+
+		slot(_nodes, h)->~T();
+		del_node.next = _free;
+		_free = h;
+		_size--;
+		return false;
+	}
+
+	/**
+		@brief Rimuove gli elementi che soddisfano un predicato
+
+		Scorre la lista una sola volta ed elimina i nodi per cui pred è vero.
+		Il predicato viene chiamato prima della distruzione dell'elemento.
+		@param pred Predicato che riceve l'handle di un elemento.
+		@return Il numero di elementi rimossi.
+	**/
+	template <typename Pred>
+	size_type erase_if(Pred pred){
+
+		size_type removed = 0;
+		handle h = _head;
+
+		while(h != null()){
+			handle next = _nodes[h].next;
+			if(pred(h)){
+				erase(h);
+				removed++;
+			}
+			h = next;
+		}
+		return removed;
+	}
+
+	/**
+		@brief Copia il contenuto di un'altra lista
+
+		Rende this una copia di other, con gli elementi in celle consecutive
+		nell'ordine della lista; se T è banalmente copiabile l'array dei nodi viene
+		invece copiato così com'è con un'unica memcpy. L'array esistente viene
+		riutilizzato se è abbastanza grande. In caso di eccezione la lista viene svuotata.
+		@param other Lista sorgente.
+	**/
+	void assign(const container &other){
+
+		reset();
+		try{
+			if constexpr (std::is_trivially_copyable<T>::value){
+				//copia dei nodi così come sono, collegamenti e celle libere comprese
+				reserve(other._used);
+				if(other._used > 0)
+					std::memcpy(static_cast<void *>(_nodes), other._nodes, other._used * sizeof(node));
+				_used = other._used;
+				_size = other._size;
+				_head = other._head;
+				_tail = other._tail;
+				_free = other._free;
+				return;
+			}
+			reserve(other._size);
+			for(handle h = other._head; h != null(); h = other._nodes[h].next)
+				emplace_back(*slot(other._nodes, h));
+		}catch(...){
+			clear();
+			throw;
+		}
+	}
+
+	/**
+		@brief Rimuove l'ultimo elemento
+
+		@pre La lista non deve essere vuota.
+	**/
+	void pop_back(void){
+		erase(_tail);
+	}
+
+	/**
+		@brief Svuota la lista
+
+		Distrugge gli elementi e libera l'array.
+	**/
+	void clear(void){
+
+		reset();
+		if(_nodes != 0){
+			node_traits::deallocate(_alloc, _nodes, _capacity);
+			_nodes = 0;
+			_capacity = 0;
+		}
+	}
+
+	/**
+		@brief Scambia il contenuto di due liste
+
+		@param other Lista con cui scambiare il contenuto.
+	**/
+	void swap(container &other) noexcept{
+		std::swap(_nodes, other._nodes);
+		std::swap(_capacity, other._capacity);
+		std::swap(_used, other._used);
+		std::swap(_size, other._size);
+		std::swap(_head, other._head);
+		std::swap(_tail, other._tail);
+		std::swap(_free, other._free);
+		std::swap(_alloc, other._alloc);
+	}
+};
+
+/**
+	@brief Politica di gestione dei duplicati negli inserimenti multipli
+
+	Stabilisce il comportamento di set::add_bulk quando un elemento del lotto
+	è già presente nel set (o compare più volte nel lotto).
+**/
+enum duplicate_policy{
+	duplicates_throw,	///< Annulla l'intero inserimento e lancia already_existing_exception
+	duplicates_skip		///< Scarta il duplicato e prosegue con l'elemento successivo
+};
+
+namespace set_detail{
+
+/**
+	@brief Politica di memorizzazione di default
+
+	list_storage, salvo per i set di tipi aritmetici con l'uguaglianza standard
+	e senza indice hash, per i quali la ricerca lineare su un array contiguo
+	(vector_storage) può usare le istruzioni SIMD.
+**/
+template <typename T, typename Eql, typename Hash>
+struct default_storage{
+	typedef typename std::conditional<std::is_same<Hash, no_hash>::value && simd_scannable<T, Eql>::value,
+		vector_storage, list_storage>::type type;
+};
+
+} // namespace set_detail
+
+/**
+	@brief Set di elementi generici
+
+	Classe che rappresenta un set di elementi generici.
+	Il modo in cui gli elementi sono memorizzati è stabilito dalla politica Storage:
+	di default il set è implementato con una lista doppiamente linkata (list_storage),
+	in alternativa con un array contiguo (vector_storage) o con un array che mantiene
+	i primi K elementi all'interno dell'oggetto stesso (small_storage<K>), oppure con una lista
+	i cui nodi sono celle di un unico array collegate da indici a 32 bit (compact_storage),
+	che riduce la memoria per elemento. La memoria degli elementi
+	viene ottenuta dall'allocatore Alloc (es. node_pool_allocator per allocare i nodi
+	della lista da un pool).
+	Il numero di elementi è di tipo std::size_t.
+	Se il parametro Hash è un funtore di hash (es. std::hash<T>), il set mantiene
+	accanto agli elementi un indice hash ad indirizzamento aperto, e la ricerca di un
+	elemento ha costo atteso costante. Il funtore Hash deve essere coerente con Eql:
+	valori uguali secondo Eql devono avere lo stesso hash.
+	L'iterazione avviene comunque sempre in ordine di inserimento.
+	Per i tipi aritmetici con l'uguaglianza standard (Eql = std::equal_to<T>, il default)
+	e senza indice hash, la politica di default è vector_storage e la ricerca di un
+	elemento confronta più valori per istruzione (SSE2, oppure AVX2 se il processore
+	lo supporta).
+	Il parametro Stats abilita la strumentazione: con no_stats (il default) il set
+	non ha costi aggiuntivi, con counting_stats o sampled_stats conta le operazioni
+	e le espone tramite stats().
+	I funtori Eql e Hash privi di stato non occupano memoria nel set, e per i tipi
+	banalmente copiabili la copia di un array (vector_storage, small_storage,
+	compact_storage) avviene con un'unica memcpy.
+**/
+template <typename T, typename Eql = std::equal_to<T>, typename Hash = no_hash,
+	typename Storage = typename set_detail::default_storage<T, Eql, Hash>::type,
+	typename Alloc = std::allocator<T>, typename Stats = no_stats>
+class set : private set_detail::functor_holder<Eql, 0>, private set_detail::functor_holder<Hash, 1>,
+	private set_detail::stats_holder<Stats>{
+
+private:
+	typedef std::size_t size_type;	///< Definzione del tipo corrispondente a size
+	typedef typename Storage::template container<T, Alloc> storage_type;	///< Tipo del contenitore degli elementi
+	typedef typename storage_type::handle handle;	///< Tipo dell'handle di un elemento nel contenitore
+
+	static const bool hashed = !std::is_same<Hash, no_hash>::value;	///< Vero se il set mantiene l'indice hash
+	static const bool simd = !hashed && storage_type::random_access &&
+		set_detail::simd_scannable<T, Eql>::value;	///< Vero se la ricerca lineare usa istruzioni SIMD
+	static const unsigned int inline_capacity = storage_type::inline_capacity;	///< Elementi memorizzati senza allocazioni
+	static const bool lazy_index = hashed && inline_capacity > 0;	///< Vero se l'indice hash viene costruito solo oltre inline_capacity elementi
+
+	typedef typename std::conditional<hashed,
+		set_detail::hash_index<handle>, set_detail::no_index>::type index_type;	///< Tipo dell'indice hash
+	typedef typename Stats::timer timer;	///< Cronometro delle operazioni
+	typedef set_detail::functor_holder<Eql, 0> equal_base;	///< Base che contiene il funtore di uguaglianza
+	typedef set_detail::functor_holder<Hash, 1> hash_base;	///< Base che contiene il funtore di hash
+
+	/**
+		@brief Stato della tabella delle posizioni
+	**/
+	enum positions_state : unsigned char{
+		positions_stale,	///< La tabella va ricostruita
+		positions_building,	///< Un thread sta costruendo la tabella in operator[]
+		positions_ready	///< La tabella riflette il contenuto del set
+	};
+
+	storage_type _data;	///< Contenitore degli elementi del set
+	mutable std::vector<handle> _positions;	///< Tabella delle posizioni usata da operator[]
+	index_type _index;	///< Indice hash degli elementi del contenitore
+	mutable std::atomic<positions_state> _positions_state;	///< Stato di _positions rispetto al contenuto del set
+
+	/**
+		@brief Funtore per l'uguaglianza
+
+		@return Il riferimento al funtore Eql del set.
+	**/
+	const Eql &equal(void) const{
+		return equal_base::functor();
+	}
+
+	/**
+		@brief Funtore di hash
+
+		@return Il riferimento al funtore Hash del set.
+	**/
+	const Hash &hasher(void) const{
+		return hash_base::functor();
+	}
+
+	/**
+		@brief Invalida la tabella delle posizioni
+
+		La tabella verrà ricostruita al successivo accesso tramite operator[].
+		Da chiamare quando una modifica non può essere riportata sulla tabella
+		in modo incrementale.
+	**/
+	void invalidate_positions(void){
+		_positions.clear();
+		_positions_state = positions_stale;
+	}
+
+	/**
+		@brief Verifica se l'indice hash contiene tutti gli elementi
+
+		Con un contenitore a buffer interno (small_storage) l'indice viene costruito
+		solo quando il set supera inline_capacity elementi; fino ad allora è vuoto
+		e la ricerca è lineare. Negli altri casi l'indice è sempre completo.
+		@return true se la ricerca può usare l'indice hash.
+	**/
+	bool index_ready(void) const{
+		if constexpr (lazy_index)
+			return _index.size() == _data.size();
+		else
+			return true;
+	}
+
+	/**
+		@brief Predispone l'indice hash per n elementi
+
+		Con un contenitore a buffer interno l'indice viene predisposto
+		solo se n supera inline_capacity.
+		@param n Numero di elementi.
+	**/
+	void reserve_index(size_type n){
+		if constexpr (hashed)
+			if(!lazy_index || n > inline_capacity)
+				_index.reserve(n);
+	}
+
+	/**
+		@brief Hash di un valore
+
+		@param v Valore di cui calcolare l'hash.
+		@return L'hash del valore, oppure 0 se il set non usa l'indice hash.
+	**/
+	std::size_t hash_value(const T &v) const{
+		if constexpr (hashed)
+			return hasher()(v);
+		else
+			return 0;
+	}
+
+	/**
+		@brief Ricerca di un elemento nel set
+
+		Ricerca per valore un elemento nel set e ne restituisce l'handle.
+		Se l'elemento non è presente nel set, ritorna l'handle nullo.
+		@param v Valore da ricercare nel set.
+		@return Handle dell'elemento ricercato.
+	**/
+	handle search(const T &v) const{
+		return search(v, hash_value(v));
+	}
+
+	/**
+		@brief Ricerca di un elemento nel set dato il suo hash
+
+		Se il set usa l'indice hash la ricerca ha costo atteso costante,
+		altrimenti gli elementi vengono scanditi dal primo fino a stop escluso.
+		@param v Valore da ricercare nel set.
+		@param h Hash del valore, calcolato con hash_value.
+		@param stop Handle dell'elemento a cui fermare la scansione lineare,
+		di default l'handle nullo (fine del contenitore).
+		@return Handle dell'elemento ricercato, oppure l'handle nullo.
+	**/
+	handle search(const T &v, std::size_t h, handle stop = storage_type::null()) const{
+
+		unsigned long long visited = 0;
+
+		if constexpr (hashed){
+			if(index_ready()){
+				handle found = _index.find(h, [&](handle n){
+					visited++;
+					return equal()(_data.value(n), v);
+				});
+				this->stats_policy().on_lookup(visited);
+				return found;
+			}
+		}
+
+		if constexpr (simd){
+			(void)h;
+			handle found = _data.scan(v, stop);
+			if constexpr (Stats::enabled)
+				visited = found != storage_type::null() ? found + 1 :
+					stop != storage_type::null() ? stop : _data.size();
+			this->stats_policy().on_lookup(visited);
+			return found;
+		}
+		else{
+			(void)h;
+			handle tmp = _data.first();
+
+			while(tmp != stop && !equal()(_data.value(tmp), v)){
+				tmp = _data.next(tmp);
+				visited++;
+			}
+
+			if(tmp != stop)
+				visited++;
+			this->stats_policy().on_lookup(visited);
+			return tmp == stop ? storage_type::null() : tmp;
+		}
+	}
+
+	/**
+		@brief Ricerca di un elemento tramite una chiave eterogenea
+
+		Come search, ma la chiave viene passata direttamente ai funtori
+		Eql e Hash senza costruire un valore di tipo T.
+		@param key Chiave da ricercare nel set.
+		@return Handle dell'elemento ricercato, oppure l'handle nullo.
+	**/
+	template <typename K>
+	handle search_key(const K &key) const{
+
+		unsigned long long visited = 0;
+
+		if constexpr (hashed){
+			if(index_ready()){
+				handle found = _index.find(hasher()(key), [&](handle n){
+					visited++;
+					return equal()(_data.value(n), key);
+				});
+				this->stats_policy().on_lookup(visited);
+				return found;
+			}
+		}
+
+		handle tmp = _data.first();
+		while(tmp != storage_type::null() && !equal()(_data.value(tmp), key)){
+			tmp = _data.next(tmp);
+			visited++;
+		}
+
+		if(tmp != storage_type::null())
+			visited++;
+		this->stats_policy().on_lookup(visited);
+		return tmp;
+	}
+
+	/**
+		@brief Copia l'indice hash di un altro set
+
+		Da chiamare dopo aver copiato in this il contenitore di other. Se gli handle
+		dei due contenitori coincidono (array senza lapidi) la tabella viene copiata
+		così com'è, altrimenti viene ricostruita ricalcolando gli hash: in nessun caso
+		vengono effettuati confronti tra elementi.
+		@param other Set sorgente.
+	**/
+	void copy_index(const set &other){
+
+		if constexpr (hashed){
+			if constexpr (storage_type::random_access){
+				if(other._data.dense()){
+					_index = other._index;
+					return;
+				}
+			}
+			rebuild_index();
+		}
+	}
 
-/**
-	@file set.h 
-	@brief Dichiarazione della classe set
-**/
+	/**
+		@brief Registra un elemento appena aggiunto in coda
 
-/**
-	@brief Dichiarazione dell'eccezione already_existing_exception
+		Inserisce l'elemento nell'indice hash e nella tabella delle posizioni.
+		Se l'inserimento nell'indice fallisce l'elemento viene rimosso dal contenitore.
+		@param n Handle dell'elemento, che deve essere l'ultimo del contenitore.
+		@param h Hash del valore dell'elemento.
+	**/
+	void link_back(handle n, std::size_t h){
+
+		if constexpr (hashed){
+			try{
+				if(!lazy_index || _index.size() + 1 == _data.size()){
+					if(!lazy_index || _data.size() > inline_capacity){
+						std::size_t slots = _index.capacity();
+						_index.insert(h, n);
+						if(_index.capacity() != slots)
+							this->stats_policy().on_allocation();
+					}
+					else
+						//ancora nel buffer interno: l'indice resta vuoto
+						_index.clear();
+				}
+				else if(_data.size() > inline_capacity){
+					//superato il buffer interno: l'indice viene costruito
+					rebuild_index();
+					this->stats_policy().on_allocation();
+				}
+			}catch(...){
+				if constexpr (lazy_index)
+					_index.clear();
+				_data.pop_back();
+				throw;
+			}
+		}
 
-	L'eccezione viene lanciata quando si tenta di aggiungere in un set
-	un elemento già esistente (nel set stesso).
-**/
-class already_existing_exception{};
+		this->stats_policy().on_add();
+		if(_positions_state == positions_ready){
+			try{
+				_positions.push_back(n);
+			}catch(...){
+				invalidate_positions();
+			}
+		}
+	}
 
-/**
-	@brief Dichiarazione dell'eccezione not_existing_exception
+	/**
+		@brief Rimuove gli ultimi n elementi
 
-	L'eccezione viene lanciata quando si tenta di rimuovere un elemento
-	non esistente in un set.
-**/
-class not_existing_exception{};
+		Annulla gli ultimi n inserimenti in coda, aggiornando l'indice hash.
+		@param n Numero di elementi da rimuovere.
+	**/
+	void pop_back(size_type n){
+
+		if(_positions_state == positions_ready)
+			_positions.resize(_positions.size() - n);
+		while(n-- > 0){
+			handle last = _data.last();
+			if constexpr (hashed)
+				if(index_ready())
+					_index.erase(hasher()(_data.value(last)), last);
+			_data.pop_back();
+		}
+	}
 
-/**
-	@brief Set di elementi generici
+	/**
+		@brief Aggiunge una sequenza di elementi
+
+		Implementazione comune di add_bulk. Se la lunghezza della sequenza è nota
+		(iteratori almeno forward) il contenitore e l'indice hash vengono predisposti
+		una sola volta per l'intero lotto. Ogni elemento viene poi cercato una sola
+		volta: i duplicati interni al lotto vengono riconosciuti perché gli elementi
+		già inseriti sono presenti nell'indice.
+		Se viene lanciata un'eccezione (anche da on_duplicate) gli elementi
+		aggiunti dalla sequenza vengono rimossi e il set torna allo stato iniziale.
+		@param b Iteratore all'inizio della sequenza di dati.
+		@param e Iteratore alla fine della sequenza di dati.
+		@param on_duplicate Funtore chiamato con ogni elemento già esistente.
+		@return Il numero di elementi aggiunti.
+	**/
+	template <typename Q, typename OnDuplicate>
+	size_type add_sequence(Q b, Q e, OnDuplicate on_duplicate){
 
-	Classe che rappresenta un set di elementi generici.
-	Il set è stato implementato con una lista doppiamente linkata.
-**/
-template <typename T, typename Eql>
-class set{
+		typedef typename std::iterator_traits<Q>::iterator_category category;
+		size_type added = 0;
+
+		try{
+			if constexpr (std::is_base_of<std::forward_iterator_tag, category>::value){
+				size_type n = size() + static_cast<size_type>(std::distance(b, e));
+				_data.reserve(n);
+				reserve_index(n);
+			}
+
+			for(; b != e; ++b){
+				bool inserted;
+				if constexpr (std::is_same<typename std::decay<decltype(*b)>::type, T>::value)
+					inserted = add_value(*b);
+				else
+					inserted = add_value(static_cast<T>(*b));
+
+				if(inserted)
+					added++;
+				else
+					on_duplicate(*b);
+			}
+		}catch(...){
+			pop_back(added);
+			throw;
+		}
+		return added;
+	}
 
-private:
-	typedef unsigned int size_type;	///< Definzione del tipo corrispondente a size
-	
 	/**
-		@brief Singolo nodo della lista
+		@brief Rimuove gli elementi che soddisfano un predicato
 
-		Struttura che definisce il singolo elemento della lista doppiamente linkata.
+		Scorre il set una sola volta e rimuove gli elementi per cui pred è vero,
+		mantenendo aggiornati l'indice hash e la tabella delle posizioni.
+		@param pred Predicato che riceve il valore di un elemento.
+		@return Il numero di elementi rimossi.
 	**/
-	struct node{
-		T value;	///< Dato di tipo generico T
-		node *previous;	///< Puntatore all'elemento precedente della lista
-		node *next;	///< Puntatore all'elemento successivo della lista	
+	template <typename Pred>
+	size_type remove_where(Pred pred){
 
-		/**
-		@brief Costruttore secondario
+		size_type removed;
 
-			Costruttore secondario. Permette di istanziare un nodo con un dato valore.
-			@param v Valore con cui inizializzare il nodo.
-			@param prev Puntatore al nodo precedente, di default è 0.
-			@param succ Puntatore al nodo successivo, di default è 0.
-		**/
-		node(const T &v, node *prev=0, node *succ=0) : 
-			value(v), previous(prev), next(succ) {}
-	};
+		try{
+			removed = _data.erase_if([&](handle n){
+				if(!pred(_data.value(n)))
+					return false;
+				if constexpr (hashed && !storage_type::random_access)
+					_index.erase(hasher()(_data.value(n)), n);
+				return true;
+			});
+		}catch(...){
+			invalidate_positions();
+			if constexpr (storage_type::random_access)
+				rebuild_index();
+			throw;
+		}
 
-	node *_head;	///< Puntatore alla testa della lista di dati di tipo generico T
-	node *_tail;	///< Puntatore alla coda della lista di dati di tipo generico T
-	size_type _size;	///< Dimensione della lista
-	Eql _equal;		///< Definizione del tipo di comparazione uguaglianza
+		this->stats_policy().on_remove(removed);
+		if(removed > 0){
+			invalidate_positions();
+			if constexpr (storage_type::random_access)
+				//l'array è stato compattato
+				rebuild_index();
+		}
+		return removed;
+	}
 
 	/**
-		@brief Ricerca di un elemento nel set
+		@brief Conta l'allocazione del prossimo inserimento
 
-		Ricerca per valore un elemento nel set e ne restituisce un puntatore.
-		Se l'elemento non è presente nel set, ritorna 0.
-		@param v Valore da ricercare nel set.
-		@return Puntatore all'elemento ricercato.
+		Con una politica di strumentazione abilitata registra un'allocazione
+		se il contenitore non ha spazio per un nuovo elemento.
 	**/
-	node *search(const T &v) const{
+	void count_allocation(void) const{
+		if constexpr (Stats::enabled)
+			if(_data.full())
+				this->stats_policy().on_allocation();
+	}
 
-		node *tmp = _head;
+	/**
+		@brief Aggiunge un elemento al set
 
-		while(tmp != 0 && !_equal(tmp->value, v))
-			tmp = tmp->next;
-		
-		return tmp;
+		Implementazione comune di add e try_add per valori copiati o spostati.
+		L'esistenza dell'elemento viene verificata prima di allocare memoria.
+		@param value Il valore da aggiungere al set.
+		@return true se l'elemento è stato aggiunto, false se era già esistente.
+	**/
+	template <typename V>
+	bool add_value(V &&value){
+
+		timer t(this->stats_policy());
+		std::size_t h = hash_value(value);
+
+		if(search(value, h) != storage_type::null()){
+			//l'elemento è già esistente
+			this->stats_policy().on_duplicate();
+			return false;
+		}
+
+		//aggiungo l'elemento in coda
+		count_allocation();
+		link_back(_data.emplace_back(std::forward<V>(value)), h);
+		return true;
+	}
+
+	/**
+		@brief Aggiunge in coda un elemento sicuramente non presente
+
+		Non effettua la ricerca dell'elemento nel set.
+		@pre value non deve essere già presente nel set.
+		@param value Il valore da aggiungere al set.
+		@param h Hash del valore, calcolato con hash_value.
+	**/
+	template <typename V>
+	void append_unique(V &&value, std::size_t h){
+		count_allocation();
+		link_back(_data.emplace_back(std::forward<V>(value)), h);
+	}
+
+	/**
+		@brief Predispone il set per n elementi
+
+		@param n Numero di elementi da poter contenere senza riallocazioni.
+	**/
+	void reserve(size_type n){
+		_data.reserve(n);
+		reserve_index(n);
+	}
+
+	friend struct set_detail::set_access;
+
+	/**
+		@brief Ricostruisce l'indice hash
+
+		Reinserisce nell'indice tutti gli elementi del contenitore, dopo che
+		una rimozione ne ha spostato gli elementi in memoria. La tabella
+		esistente viene riutilizzata, quindi non servono allocazioni.
+	**/
+	void rebuild_index(void){
+
+		if constexpr (hashed){
+			if constexpr (lazy_index){
+				if(_data.size() <= inline_capacity){
+					_index.clear();
+					return;
+				}
+			}
+			_index.reset();
+			_index.reserve(_data.size());
+			for(handle n = _data.first(); n != storage_type::null(); n = _data.next(n))
+				_index.insert(hasher()(_data.value(n)), n);
+		}
 	}
 
 public:
@@ -91,27 +2814,33 @@ public:
 
 		Costruttore di default per istanziare un set vuoto.
 	**/
-	set() : _head(0), _tail(0), _size(0) {}
+	set() : _index(storage_type::null()), _positions_state(positions_stale) {}
 
 	/**
 		@brief Costruttore secondario (COSTRUTTORE DI COPIA)
 
 		Costruttore secondario. Permette di creare un set come copia
-		di un altro set.
+		di un altro set. Gli elementi di other sono già unici, quindi vengono
+		copiati in un'unica passata in tempo O(N), senza controllarne l'unicità.
 		@param other Set sorgente.
 	**/
-	set(const set &other) : _head(0), _tail(0), _size(0) {
+	set(const set &other) : equal_base(other.equal()), hash_base(other.hasher()),
+		_index(storage_type::null()), _positions_state(positions_stale) {
 
-		node *tmp = other._head;
-		try{
-			while(tmp != 0){
-				add(tmp->value);
-				tmp = tmp->next;
-			}
-		} catch(...){
-			clear_set();
-			throw;
-		}
+		_data.assign(other._data);
+		copy_index(other);
+	}
+
+	/**
+		@brief Costruttore secondario (COSTRUTTORE DI SPOSTAMENTO)
+
+		Costruttore secondario. Permette di creare un set acquisendo gli elementi
+		di un altro set senza copiarli; il set sorgente rimane vuoto.
+		@param other Set sorgente.
+	**/
+	set(set &&other) noexcept(std::is_nothrow_default_constructible<Alloc>::value)
+		: _index(storage_type::null()), _positions_state(positions_stale) {
+		swap(other);
 	}
 
 	/**
@@ -123,14 +2852,8 @@ public:
 		@param e Iteratore alla fine della sequenza di dati.
 	**/
 	template <typename Q>
-	set(Q b, Q e) : _head(0), _tail(0), _size(0) {
-		try{
-			for(; b!=e; ++b)
-				add(static_cast<T>(*b));
-		} catch (...){
-			clear_set();
-			throw;
-		}
+	set(Q b, Q e) : _index(storage_type::null()), _positions_state(positions_stale) {
+		add_bulk(b, e);
 	}
 
 	/**
@@ -146,24 +2869,78 @@ public:
 		@brief Operatore di assegnamento
 
 		Operatore di assegnamento. Permette la copia tra set.
+		La copia avviene in un'unica passata in tempo O(N), riutilizzando
+		i nodi (o l'array) già allocati da this.
+		In caso di eccezione this viene svuotato.
 		@param other Set sorgente.
 		@return Riferimento a this.
 	**/
 	set &operator=(const set &other){
 
 		if(this != &other){
-			set tmp(other);
-			std::swap(tmp._head, _head);
-			std::swap(tmp._tail, _tail);
-			std::swap(tmp._size, _size);
+			invalidate_positions();
+			try{
+				equal_base::functor() = other.equal();
+				hash_base::functor() = other.hasher();
+				_data.assign(other._data);
+				copy_index(other);
+			}catch(...){
+				clear_set();
+				throw;
+			}
+		}
+		return *this;
+	}
+
+	/**
+		@brief Operatore di assegnamento per spostamento
+
+		Operatore di assegnamento. Libera gli elementi di this e acquisisce
+		quelli di other senza copiarli; il set sorgente rimane vuoto.
+		@param other Set sorgente.
+		@return Riferimento a this.
+	**/
+	set &operator=(set &&other) noexcept{
+
+		if(this != &other){
+			clear_set();
+			swap(other);
 		}
 		return *this;
 	}
 
+	/**
+		@brief Scambia il contenuto di due set
+
+		Scambia gli elementi di due set in tempo costante, senza copiarli.
+		@param other Set con cui scambiare il contenuto.
+	**/
+	void swap(set &other) noexcept{
+		_data.swap(other._data);
+		std::swap(equal_base::functor(), other.equal_base::functor());
+		std::swap(hash_base::functor(), other.hash_base::functor());
+		if constexpr (hashed)
+			_index.swap(other._index);
+		_positions.swap(other._positions);
+		positions_state state = _positions_state;
+		_positions_state = other._positions_state.load();
+		other._positions_state = state;
+	}
+
 	/**
 		@brief Accesso ai dati in sola lettura
 
 		Metodo per leggere l'index-esimo elemento del set.
+		Gli indici seguono l'ordine di inserimento: dopo la rimozione dell'elemento
+		in posizione i, gli elementi successivi scalano di una posizione (quello
+		in posizione i+1 passa in posizione i), mentre quelli precedenti non cambiano.
+		L'accesso ha costo costante: con vector_storage senza lapidi l'elemento viene
+		letto direttamente dall'array, altrimenti tramite una tabella delle posizioni
+		costruita al primo accesso (O(N)) e poi aggiornata da add e remove; finché
+		la tabella esiste una remove costa O(N) per togliere la sua posizione.
+		La tabella viene costruita da un solo thread mentre gli altri attendono,
+		quindi più thread possono leggere in concorrenza lo stesso set, purché
+		nessuno lo modifichi.
 
 		@pre E' necessario che index < size.
 		@param index Indice dell'elemento nel set da leggere.
@@ -171,35 +2948,46 @@ public:
 	**/
 	const T &operator[](const size_type index) const {
 
-		assert(index < _size);
+		assert(index < size());
 
-		size_type count = 0;
-		node *tmp = _head;
+		if constexpr (storage_type::random_access){
+			if(_data.dense())
+				return _data.at(index);
+		}
 
-		while(tmp != 0 && count < index){
-			tmp = tmp->next;
-			count++;
+		while(_positions_state.load(std::memory_order_acquire) != positions_ready){
+			positions_state expected = positions_stale;
+			if(!_positions_state.compare_exchange_strong(expected, positions_building,
+				std::memory_order_acquire)){
+				//un altro thread sta costruendo la tabella
+				std::this_thread::yield();
+				continue;
+			}
+			try{
+				_positions.clear();
+				_positions.reserve(size());
+				for(handle tmp = _data.first(); tmp != storage_type::null(); tmp = _data.next(tmp))
+					_positions.push_back(tmp);
+			}catch(...){
+				_positions_state.store(positions_stale, std::memory_order_release);
+				throw;
+			}
+			_positions_state.store(positions_ready, std::memory_order_release);
 		}
-		return tmp->value;
+		return _data.value(_positions[index]);
 	}
 
 	/**
 		@brief Svuota il set
 
-		Metodo che itera sul set ed elimina tutti gli elementi liberando la memoria. 
+		Metodo che elimina tutti gli elementi del set liberando la memoria. 
 	**/
 	void clear_set(void){
-		node *tmp = _head;
-
-		while(tmp != 0){
-			node *next = tmp->next;
-			_head = next;
-			delete tmp;
-			if(_head == 0)
-				_tail = 0;
-			_size--;
-			tmp = next;
-		}
+		_data.clear();
+		if constexpr (hashed)
+			_index.clear();
+		invalidate_positions();
+		std::vector<handle>().swap(_positions);
 	}
 	
 	/**
@@ -211,31 +2999,124 @@ public:
 		in caso di elemento già esistente nel set.
 	**/
 	void add(const T &value){
+		if(!add_value(value))
+			throw already_existing_exception();
+	}
 
-		node *new_node = new node(value);
+	/**
+		@brief Aggiunge un elemento al set spostandolo
 
-		//caso in cui il set è vuoto
-		if(_head == 0){
-			_head = new_node;
-			_tail = new_node;
-			_size++;
-			return;
-		}
-		
-		//caso in cui ho almeno un elemento nel set
-		if(search(value) == 0){
-			//aggiungo l'elemento in coda
-			new_node->previous = _tail;	
-			_tail->next = new_node;
-			_tail = new_node;
-        	_size++;
-		}
-		else{
-			//l'elemento è già esistente
-			delete new_node;
-			new_node = 0;
+		Metodo che aggiunge un elemento, se non è già esistente, al set.
+		Il valore viene spostato nel set invece che copiato; se l'elemento
+		è già esistente value non viene modificato.
+		@param value Il valore da aggiungere al set.
+		@throw already_existing_exception Eccezione che viene lanciata
+		in caso di elemento già esistente nel set.
+	**/
+	void add(T &&value){
+		if(!add_value(std::move(value)))
 			throw already_existing_exception();
+	}
+
+	/**
+		@brief Aggiunge un elemento al set, se non esistente
+
+		Versione di add che non lancia eccezioni in caso di elemento già esistente.
+		L'esistenza viene verificata prima di allocare memoria, quindi un duplicato
+		non comporta né allocazioni né eccezioni.
+		@param value Il valore da aggiungere al set.
+		@return true se l'elemento è stato aggiunto, false se era già esistente.
+	**/
+	bool try_add(const T &value){
+		return add_value(value);
+	}
+
+	/**
+		@brief Aggiunge un elemento al set spostandolo, se non esistente
+
+		Versione di add(T&&) che non lancia eccezioni in caso di elemento già esistente;
+		in tal caso value non viene modificato.
+		@param value Il valore da aggiungere al set.
+		@return true se l'elemento è stato aggiunto, false se era già esistente.
+	**/
+	bool try_add(T &&value){
+		return add_value(std::move(value));
+	}
+
+	/**
+		@brief Aggiunge al set una sequenza di elementi
+
+		Metodo che aggiunge al set, in un'unica passata, gli elementi di una sequenza
+		definita da una coppia generica di iteratori. Con l'indice hash e iteratori
+		almeno forward la memoria viene predisposta una sola volta per l'intero lotto
+		e il costo atteso è O(M) per M elementi; senza indice hash ogni elemento
+		richiede comunque una scansione del set.
+		Con duplicates_throw l'inserimento è atomico: se un elemento è già presente
+		(nel set o nel lotto) nessun elemento viene aggiunto.
+		@param b Iteratore all'inizio della sequenza di dati.
+		@param e Iteratore alla fine della sequenza di dati.
+		@param policy Comportamento in presenza di duplicati, di default duplicates_throw.
+		@throw already_existing_exception Eccezione che viene lanciata con duplicates_throw
+		in caso di elemento già esistente.
+		@return Il numero di elementi aggiunti.
+	**/
+	template <typename Q>
+	size_type add_bulk(Q b, Q e, duplicate_policy policy = duplicates_throw){
+		return add_sequence(b, e, [policy](const auto &){
+			if(policy == duplicates_throw)
+				throw already_existing_exception();
+		});
+	}
+
+	/**
+		@brief Aggiunge al set una sequenza di elementi segnalando i duplicati
+
+		Come add_bulk con duplicates_skip, ma ogni elemento scartato perché già
+		esistente viene scritto sull'iteratore di output rejected.
+		@param b Iteratore all'inizio della sequenza di dati.
+		@param e Iteratore alla fine della sequenza di dati.
+		@param rejected Iteratore di output su cui scrivere i duplicati.
+		@return Il numero di elementi aggiunti.
+	**/
+	template <typename Q, typename Out>
+	size_type add_bulk(Q b, Q e, Out rejected){
+		return add_sequence(b, e, [&rejected](const auto &v){
+			*rejected = v;
+			++rejected;
+		});
+	}
+
+	/**
+		@brief Costruisce un elemento direttamente nel set
+
+		Metodo che costruisce un elemento a partire dagli argomenti del costruttore
+		di T direttamente nella memoria del set, senza copie né spostamenti.
+		Poiché il confronto richiede il valore già costruito, un elemento duplicato
+		viene costruito e subito distrutto.
+		@param args Argomenti del costruttore di T.
+		@throw already_existing_exception Eccezione che viene lanciata
+		in caso di elemento già esistente nel set.
+	**/
+	template <typename... Args>
+	void emplace(Args&&... args){
+
+		timer t(this->stats_policy());
+		count_allocation();
+		handle n = _data.emplace_back(std::forward<Args>(args)...);
+		std::size_t h;
+
+		try{
+			h = hash_value(_data.value(n));
+			if(search(_data.value(n), h, n) != storage_type::null()){
+				//l'elemento è già esistente
+				this->stats_policy().on_duplicate();
+				throw already_existing_exception();
+			}
+		}catch(...){
+			_data.pop_back();
+			throw;
 		}
+		link_back(n, h);
 	}
 
 	/**
@@ -247,39 +3128,151 @@ public:
 		in caso di elemento non esistente nel set.
 	**/
 	void remove(const T &value){
+		if(!try_remove(value))
+			//l'elemento da cancellare non esiste nel set
+			throw not_existing_exception();
+	}
+
+	/**
+		@brief Rimuove un elemento dal set, se esistente
+
+		Versione di remove che non lancia eccezioni in caso di elemento non esistente.
+		@param value Il valore da rimuovere dal set.
+		@return true se l'elemento è stato rimosso, false se non era presente.
+	**/
+	bool try_remove(const T &value){
 		
-		node *del_node = search(value);
-
-		if(del_node != 0){	
-			//l'elemento da cancellare esiste nel set
-			if(del_node == _head){
-				//l'elemento da cancellare è in testa
-				_head = del_node->next;
-				if(_head != 0)
-					//il set è composto da almeno due elementi
-					_head->previous = 0;
-				else
-					//il set è composto da un solo elemento
-					_tail = 0;
+		timer t(this->stats_policy());
+		std::size_t h = hash_value(value);
+		handle del_node = search(value, h);
+
+		if(del_node == storage_type::null())
+			return false;
+
+		if constexpr (hashed)
+			if(index_ready())
+				_index.erase(h, del_node);
+		if(_positions_state == positions_ready){
+			typename std::vector<handle>::iterator slot;
+			if constexpr (storage_type::random_access)
+				//gli handle dell'array crescono con la posizione
+				slot = std::lower_bound(_positions.begin(), _positions.end(), del_node);
+			else
+				slot = std::find(_positions.begin(), _positions.end(), del_node);
+			_positions.erase(slot);
+		}
+
+		if(_data.erase(del_node)){
+			//il contenitore ha spostato gli elementi
+			rebuild_index();
+			invalidate_positions();
+		}
+		this->stats_policy().on_remove(1);
+		return true;
+	}
+
+	/**
+		@brief Rimuove dal set gli elementi che soddisfano un predicato
+
+		Metodo che scorre il set una sola volta e rimuove sul posto gli elementi
+		per cui il predicato è vero, senza costruire un nuovo set né copiare
+		gli elementi rimanenti, di cui viene mantenuto l'ordine.
+		Il tipo templato Pred definisce il tipo del predicato.
+		@param P Predicato applicato agli elementi del set.
+		@return Il numero di elementi rimossi.
+	**/
+	template <typename Pred>
+	size_type erase_if(Pred P){
+		return remove_where(P);
+	}
+
+	/**
+		@brief Mantiene nel set solo gli elementi che soddisfano un predicato
+
+		Metodo complementare a erase_if: rimuove sul posto gli elementi
+		per cui il predicato è falso.
+		@param P Predicato applicato agli elementi del set.
+		@return Il numero di elementi rimossi.
+	**/
+	template <typename Pred>
+	size_type retain_if(Pred P){
+		return remove_where([&](const T &v){ return !P(v); });
+	}
+
+	/**
+		@brief Unione con un altro set
+
+		Aggiunge in coda a this, nel loro ordine, gli elementi di other non ancora presenti.
+		Con l'indice hash il costo atteso è O(M), con M la dimensione di other;
+		senza indice è O(N*M).
+		@param other Set da unire a this.
+		@return Riferimento a this.
+	**/
+	set &operator|=(const set &other){
+
+		if(this != &other){
+			reserve_index(size() + other.size());
+			for(handle n = other._data.first(); n != storage_type::null(); n = other._data.next(n))
+				add_value(other._data.value(n));
+		}
+		return *this;
+	}
+
+	/**
+		@brief Intersezione con un altro set
+
+		Rimuove da this gli elementi non presenti in other, mantenendo
+		l'ordine dei rimanenti. Ogni elemento di this viene cercato in other,
+		quindi con l'indice hash il costo atteso è O(N).
+		@param other Set da intersecare con this.
+		@return Riferimento a this.
+	**/
+	set &operator&=(const set &other){
+
+		if(this != &other)
+			remove_where([&](const T &v){ return other.search(v) == storage_type::null(); });
+		return *this;
+	}
+
+	/**
+		@brief Differenza con un altro set
+
+		Rimuove da this gli elementi presenti in other, mantenendo l'ordine dei
+		rimanenti. Viene scandito il più piccolo dei due set cercandone gli elementi
+		nell'altro, quindi con l'indice hash il costo atteso è O(min(N, M)).
+		@param other Set da sottrarre a this.
+		@return Riferimento a this.
+	**/
+	set &operator-=(const set &other){
+
+		if(this == &other)
+			clear_set();
+		else if(other.size() < size())
+			for(handle n = other._data.first(); n != storage_type::null(); n = other._data.next(n))
+				try_remove(other._data.value(n));
+		else
+			remove_where([&](const T &v){ return other.search(v) != storage_type::null(); });
+		return *this;
+	}
+
+	/**
+		@brief Differenza simmetrica con un altro set
+
+		Rimuove da this gli elementi presenti in other e aggiunge in coda,
+		nel loro ordine, quelli di other non presenti in this.
+		Con l'indice hash il costo atteso è O(M).
+		@param other Set con cui calcolare la differenza simmetrica.
+		@return Riferimento a this.
+	**/
+	set &operator^=(const set &other){
 
-				delete del_node;
-				del_node = 0;
-    			_size--;
-    			return;
-			}
-			//l'elemento da cancellare non è in testa
-   			del_node->previous->next = del_node->next;
-    			if (del_node->next != 0)
-        			del_node->next->previous = del_node->previous;
-        		else
-        			_tail = del_node->previous;
-        	delete del_node;
-        	del_node = 0;
-    		_size--;
-		}
+		if(this == &other)
+			clear_set();
 		else
-			//l'elemento da cancellare non esiste nel set
-			throw not_existing_exception();
+			for(handle n = other._data.first(); n != storage_type::null(); n = other._data.next(n))
+				if(!try_remove(other._data.value(n)))
+					add_value(other._data.value(n));
+		return *this;
 	}
 
 	/**
@@ -289,7 +3282,7 @@ public:
 		@return La dimensione del set.
 	**/
 	size_type size(void) const{
-		return _size;
+		return _data.size();
 	}
 
 	/**
@@ -299,7 +3292,8 @@ public:
 		utilizzabili nella classe set.
 	**/
 	class const_iterator {
-		const node *n;
+		const storage_type *c;
+		handle n;
 	public:
 		typedef std::forward_iterator_tag iterator_category;
 		typedef T                         value_type;
@@ -312,7 +3306,7 @@ public:
 
 			Costruttore di default per istanziare un const_iterator.
 		**/
-		const_iterator() : n(0){}
+		const_iterator() : c(0), n(storage_type::null()){}
 		
 		/**
 			@brief Costruttore secondario (COSTRUTTORE DI COPIA)
@@ -321,7 +3315,7 @@ public:
 			come copia di un altro const_iterator.
 			@param other Const_iterator sorgente.
 		**/
-		const_iterator(const const_iterator &other) : n(other.n){}
+		const_iterator(const const_iterator &other) : c(other.c), n(other.n){}
 
 		/**
 			@brief Operatore di assegnamento
@@ -331,6 +3325,7 @@ public:
 			@return Riferimento a this.
 		**/
 		const_iterator& operator=(const const_iterator &other) {
+			c = other.c;
 			n = other.n;
 			return *this;
 		}
@@ -349,7 +3344,7 @@ public:
 			@return Il dato riferito dall'iteratore.
 		**/
 		reference operator*() const {
-			return n->value;
+			return c->value(n);
 		}
 
 		/**
@@ -359,7 +3354,7 @@ public:
 			@return Il puntatore al dato riferito dall'iteratore
 		**/
 		pointer operator->() const {
-			return &(n->value);
+			return &(c->value(n));
 		}
 		
 		/**
@@ -372,7 +3367,7 @@ public:
 		const_iterator operator++(int) {
 
 			const_iterator tmp(*this);
-			n = n->next;
+			n = c->next(n);
 			return tmp;
 		}
 
@@ -384,7 +3379,7 @@ public:
 			@return Il riferimento al const_iterator.
 		**/
 		const_iterator& operator++() {
-			n = n->next;
+			n = c->next(n);
 			return *this;
 		}
 
@@ -415,7 +3410,7 @@ public:
 	private:
 
 		friend class set;
-		const_iterator(const node *nn) : n(nn){}		
+		const_iterator(const storage_type *cc, handle nn) : c(cc), n(nn){}		
 	}; // classe const_iterator
 	
 	/**
@@ -424,7 +3419,7 @@ public:
 		@return L'iteratore all'inizio della sequenza di dati.
 	**/
 	const_iterator begin() const {
-		return const_iterator(_head);
+		return const_iterator(&_data, _data.first());
 	}
 	
 	/**
@@ -433,10 +3428,192 @@ public:
 		@return L'iteratore alla fine della sequenza di dati.
 	**/
 	const_iterator end() const {
-		return const_iterator(0);
+		return const_iterator(&_data, storage_type::null());
+	}
+
+	/**
+		@brief Verifica la presenza di un elemento
+
+		Non alloca memoria e non lancia eccezioni (salvo quelle di Eql e Hash).
+		@param value Il valore da cercare.
+		@return true se l'elemento è presente nel set.
+	**/
+	bool contains(const T &value) const{
+		timer t(this->stats_policy());
+		return search(value) != storage_type::null();
+	}
+
+	/**
+		@brief Verifica la presenza di un elemento tramite una chiave eterogenea
+
+		Disponibile se Eql (e Hash, se presente) dichiarano is_transparent: la chiave
+		viene confrontata con gli elementi senza costruire un valore di tipo T.
+		@param key La chiave da cercare.
+		@return true se un elemento uguale alla chiave è presente nel set.
+	**/
+	template <typename K, typename = typename std::enable_if<
+		set_detail::transparent_lookup<Eql, Hash>::value, K>::type>
+	bool contains(const K &key) const{
+		timer t(this->stats_policy());
+		return search_key(key) != storage_type::null();
+	}
+
+	/**
+		@brief Ricerca di un elemento
+
+		@param value Il valore da cercare.
+		@return L'iteratore all'elemento, oppure end() se non presente.
+	**/
+	const_iterator find(const T &value) const{
+		timer t(this->stats_policy());
+		return const_iterator(&_data, search(value));
+	}
+
+	/**
+		@brief Ricerca di un elemento tramite una chiave eterogenea
+
+		Disponibile se Eql (e Hash, se presente) dichiarano is_transparent.
+		@param key La chiave da cercare.
+		@return L'iteratore al primo elemento uguale alla chiave, oppure end().
+	**/
+	template <typename K, typename = typename std::enable_if<
+		set_detail::transparent_lookup<Eql, Hash>::value, K>::type>
+	const_iterator find(const K &key) const{
+		timer t(this->stats_policy());
+		return const_iterator(&_data, search_key(key));
+	}
+
+	/**
+		@brief Numero di occorrenze di un elemento
+
+		@param value Il valore da cercare.
+		@return 1 se l'elemento è presente nel set, 0 altrimenti.
+	**/
+	size_type count(const T &value) const{
+		return contains(value) ? 1 : 0;
+	}
+
+	/**
+		@brief Numero di occorrenze di una chiave eterogenea
+
+		Disponibile se Eql (e Hash, se presente) dichiarano is_transparent.
+		@param key La chiave da cercare.
+		@return 1 se un elemento uguale alla chiave è presente nel set, 0 altrimenti.
+	**/
+	template <typename K, typename = typename std::enable_if<
+		set_detail::transparent_lookup<Eql, Hash>::value, K>::type>
+	size_type count(const K &key) const{
+		return contains(key) ? 1 : 0;
+	}
+
+	/**
+		@brief Contatori delle operazioni
+
+		Con no_stats tutti i contatori sono nulli.
+		I contatori non vengono copiati né scambiati insieme agli elementi.
+		@return Una copia dei contatori della politica Stats.
+	**/
+	set_stats stats(void) const{
+		return this->stats_policy().snapshot();
+	}
+
+	/**
+		@brief Azzera i contatori delle operazioni
+	**/
+	void reset_stats(void){
+		this->stats_policy().reset();
+	}
+};
+
+namespace set_detail{
+
+struct set_access{
+
+	/**
+		@brief Hash di un valore secondo il funtore di un set
+
+		@param s Set di riferimento.
+		@param v Valore di cui calcolare l'hash.
+		@return L'hash del valore, oppure 0 se il set non usa l'indice hash.
+	**/
+	template <typename S, typename T>
+	static std::size_t hash(const S &s, const T &v){
+		return s.hash_value(v);
+	}
+
+	/**
+		@brief Verifica se un tipo di set usa l'indice hash
+
+		@return true se il set è istanziato con un funtore di hash.
+	**/
+	template <typename S>
+	static constexpr bool hashed(void){
+		return S::hashed;
+	}
+
+	/**
+		@brief Verifica la presenza di un valore dato il suo hash
+
+		@param s Set di riferimento.
+		@param v Valore da cercare.
+		@param h Hash del valore, calcolato con hash.
+		@return true se v è presente in s.
+	**/
+	template <typename S, typename T>
+	static bool contains(const S &s, const T &v, std::size_t h){
+		return s.search(v, h) != S::storage_type::null();
+	}
+
+	/**
+		@brief Aggiunge in coda ad un set un elemento sicuramente non presente
+
+		@pre v non deve essere già presente in s.
+		@param s Set di destinazione.
+		@param v Valore da aggiungere.
+		@param h Hash del valore, calcolato con hash.
+	**/
+	template <typename S, typename T>
+	static void append(S &s, T &&v, std::size_t h){
+		s.append_unique(std::forward<T>(v), h);
+	}
+
+	/**
+		@brief Predispone un set per n elementi
+
+		@param s Set da predisporre.
+		@param n Numero di elementi.
+	**/
+	template <typename S>
+	static void reserve(S &s, std::size_t n){
+		s.reserve(static_cast<typename S::size_type>(n));
+	}
+
+	/**
+		@brief Ultimo elemento di un set
+
+		@pre s non deve essere vuoto.
+		@param s Set di riferimento.
+		@return Il riferimento costante all'ultimo elemento inserito.
+	**/
+	template <typename S>
+	static const typename S::const_iterator::value_type &back(const S &s){
+		return s._data.value(s._data.last());
+	}
+
+	/**
+		@brief Annulla l'ultimo inserimento in un set
+
+		@pre s non deve essere vuoto.
+		@param s Set di riferimento.
+	**/
+	template <typename S>
+	static void pop_back(S &s){
+		s.pop_back(1);
 	}
 };
 
+} // namespace set_detail
+
 /**
 	@brief Operatore di stream
 
@@ -446,10 +3623,10 @@ public:
 	@param data_set Set sorgente i cui elementi verranno spediti sullo stream.
 	@return Il riferimento allo stream di output.
 **/
-template <typename T, typename E>
-std::ostream &operator<<(std::ostream &os, const set<T, E> &data_set){
+template <typename T, typename... P>
+std::ostream &operator<<(std::ostream &os, const set<T, P...> &data_set){
 
-	typename set<T, E>::const_iterator i, ie;
+	typename set<T, P...>::const_iterator i, ie;
 
 	for(i=data_set.begin(), ie=data_set.end(); i!=ie; ++i)
 		os << *i << " ";
@@ -462,26 +3639,290 @@ std::ostream &operator<<(std::ostream &os, const set<T, E> &data_set){
 	Funzione globale che dato un set generico e un predicato booleano generico, ritorna un
 	nuovo set ottenuto prendendo dal set sorgente tutti gli elementi che non
 	soddisfano il predicato.
+	Gli elementi del set sorgente sono già unici, quindi vengono aggiunti
+	al nuovo set senza controllarne l'unicità.
 	Questo metodo è templato in quanto il set in questione è di tipo templato.
 	Il tipo templato Pred definisce il tipo del predicato.
 	@param S Set sorgente.
 	@param P Predicato applicato al set sorgente.
 	@return Il set risultato dell'applicazione del predicato al set sorgente.
 **/
-template <typename T, typename Eql, typename Pred>
-set<T, Eql> filter_out(const set<T, Eql> &S, const Pred P){
+template <typename T, typename... Params, typename Pred>
+set<T, Params...> filter_out(const set<T, Params...> &S, const Pred P){
 	
-	typename set<T, Eql>::const_iterator i, ie;
-	set<T, Eql> new_set;
+	typename set<T, Params...>::const_iterator i, ie;
+	set<T, Params...> new_set;
 
 	for(i=S.begin(), ie=S.end(); i!=ie; ++i)
 
 		if(!P(*i))
-			new_set.add(*i);
+			set_detail::set_access::append(new_set, *i, set_detail::set_access::hash(new_set, *i));
+
+	return new_set;
+}
+
+/**
+	@brief Filtra un set attraverso l'uso di un predicato, in parallelo
+
+	Versione parallela di filter_out. Gli elementi del set sorgente vengono divisi in
+	blocchi contigui, uno per thread; ogni thread valuta il predicato (e, se il set usa
+	l'indice hash, l'hash dei sopravvissuti) sul proprio blocco. I sopravvissuti vengono
+	poi aggiunti al nuovo set nell'ordine originale, senza controllarne l'unicità.
+	Il predicato e il funtore di hash vengono chiamati in concorrenza da più thread,
+	quindi devono poterlo essere (es. funtori senza stato).
+	Se il predicato lancia un'eccezione, questa viene rilanciata al termine di tutti i thread.
+	@param S Set sorgente.
+	@param P Predicato applicato al set sorgente.
+	@param threads Numero di thread da usare; con 0 viene usato il numero di core disponibili.
+	@return Il set risultato dell'applicazione del predicato al set sorgente.
+**/
+template <typename T, typename... Params, typename Pred>
+set<T, Params...> filter_out(const set<T, Params...> &S, const Pred P, unsigned int threads){
+
+	typedef set<T, Params...> set_type;
+	set_type new_set;
+
+	std::vector<const T *> items;
+	items.reserve(S.size());
+	for(typename set_type::const_iterator i = S.begin(), ie = S.end(); i != ie; ++i)
+		items.push_back(&*i);
+
+	if(threads == 0)
+		threads = std::thread::hardware_concurrency();
+	if(threads == 0)
+		threads = 1;
+	if(threads > items.size())
+		threads = items.empty() ? 1 : static_cast<unsigned int>(items.size());
+
+	//per ogni elemento: 1 se sopravvive al filtro, e il suo hash
+	std::vector<unsigned char> keep(items.size());
+	std::vector<std::size_t> hashes(items.size());
+	std::vector<std::exception_ptr> errors(threads);
+	std::size_t chunk = (items.size() + threads - 1) / threads;
+
+	auto work = [&](unsigned int t){
+		try{
+			std::size_t end = std::min(items.size(), (t + 1) * chunk);
+			for(std::size_t k = t * chunk; k < end; ++k)
+				if(!P(*items[k])){
+					keep[k] = 1;
+					hashes[k] = set_detail::set_access::hash(new_set, *items[k]);
+				}
+		}catch(...){
+			errors[t] = std::current_exception();
+		}
+	};
+
+	//con la memoria già riservata solo la creazione del thread può lanciare eccezioni
+	std::vector<std::thread> workers;
+	workers.reserve(threads - 1);
+	try{
+		for(unsigned int t = 1; t < threads; ++t)
+			workers.emplace_back(work, t);
+	}catch(...){
+		//impossibile creare altri thread: i blocchi restanti vengono elaborati qui
+		for(unsigned int t = static_cast<unsigned int>(workers.size()) + 1; t < threads; ++t)
+			work(t);
+	}
+	work(0);
+	for(std::size_t t = 0; t < workers.size(); ++t)
+		workers[t].join();
+
+	for(std::size_t t = 0; t < errors.size(); ++t)
+		if(errors[t])
+			std::rethrow_exception(errors[t]);
+
+	std::size_t survivors = 0;
+	for(std::size_t k = 0; k < keep.size(); ++k)
+		survivors += keep[k];
+	set_detail::set_access::reserve(new_set, survivors);
+
+	for(std::size_t k = 0; k < items.size(); ++k)
+		if(keep[k])
+			set_detail::set_access::append(new_set, *items[k], hashes[k]);
 
 	return new_set;
 }
 
+/**
+	@brief Vista filtrata di un set
+
+	Classe che permette di iterare sugli elementi di un set che non soddisfano
+	un predicato, senza copiarli: il predicato viene valutato durante l'iterazione.
+	La vista riferisce il set sorgente, che deve sopravviverle e non deve essere
+	modificato mentre la vista viene iterata.
+	Il tipo templato S definisce il tipo del set, Pred il tipo del predicato.
+**/
+template <typename S, typename Pred>
+class filtered_view{
+
+	const S *_set;	///< Set sorgente
+	Pred _pred;	///< Predicato che identifica gli elementi da escludere
+
+public:
+	/**
+		@brief Costruttore secondario
+
+		Costruttore secondario. Permette di istanziare una vista su un set.
+		@param s Set sorgente.
+		@param p Predicato che identifica gli elementi da escludere.
+	**/
+	filtered_view(const S &s, const Pred &p) : _set(&s), _pred(p) {}
+
+	/**
+		@brief Definizione della classe const_iterator
+
+		Classe che implementa iteratori di tipo costante sulla vista,
+		che saltano gli elementi che soddisfano il predicato.
+	**/
+	class const_iterator{
+		typename S::const_iterator i, ie;
+		const Pred *p;
+
+		/**
+			@brief Avanza fino al primo elemento da non escludere
+		**/
+		void skip(void){
+			while(i != ie && (*p)(*i))
+				++i;
+		}
+
+	public:
+		typedef std::forward_iterator_tag             iterator_category;
+		typedef typename S::const_iterator::value_type value_type;
+		typedef ptrdiff_t                             difference_type;
+		typedef const value_type*                     pointer;
+		typedef const value_type&                     reference;
+
+		/**
+			@brief Costruttore di default
+
+			Costruttore di default per istanziare un const_iterator.
+		**/
+		const_iterator() : p(0) {}
+
+		/**
+			@brief Operatore di dereferenziamento
+
+			@return Il dato riferito dall'iteratore.
+		**/
+		reference operator*() const {
+			return *i;
+		}
+
+		/**
+			@brief Operatore freccia
+
+			@return Il puntatore al dato riferito dall'iteratore.
+		**/
+		pointer operator->() const {
+			return &*i;
+		}
+
+		/**
+			@brief Operatore di iterazione post-incremento
+
+			@return La copia del const_iterator non iterata.
+		**/
+		const_iterator operator++(int) {
+			const_iterator tmp(*this);
+			++i;
+			skip();
+			return tmp;
+		}
+
+		/**
+			@brief Operatore di iterazione pre-incremento
+
+			@return Il riferimento al const_iterator.
+		**/
+		const_iterator& operator++() {
+			++i;
+			skip();
+			return *this;
+		}
+
+		/**
+			@brief Operatore di uguaglianza
+
+			@param other Il const_iterator con cui effettuare la comparazione.
+			@return Il risultato della comparazione di due const_iterator.
+		**/
+		bool operator==(const const_iterator &other) const {
+			return i == other.i;
+		}
+
+		/**
+			@brief Operatore di diversità
+
+			@param other Il const_iterator con cui effettuare la comparazione.
+			@return Il risultato della comparazione di due const_iterator.
+		**/
+		bool operator!=(const const_iterator &other) const {
+			return i != other.i;
+		}
+
+	private:
+
+		friend class filtered_view;
+		const_iterator(typename S::const_iterator b, typename S::const_iterator e, const Pred *pp)
+			: i(b), ie(e), p(pp) {
+			skip();
+		}
+	}; // classe const_iterator
+
+	/**
+		@brief Iteratore all'inizio della vista
+
+		@return L'iteratore al primo elemento che non soddisfa il predicato.
+	**/
+	const_iterator begin() const {
+		return const_iterator(_set->begin(), _set->end(), &_pred);
+	}
+
+	/**
+		@brief Iteratore alla fine della vista
+
+		@return L'iteratore alla fine della vista.
+	**/
+	const_iterator end() const {
+		return const_iterator(_set->end(), _set->end(), &_pred);
+	}
+};
+
+/**
+	@brief Vista filtrata di un set attraverso l'uso di un predicato
+
+	Funzione globale analoga a filter_out che, invece di costruire un nuovo set,
+	ritorna una vista sugli elementi del set sorgente che non soddisfano il predicato.
+	Non effettua allocazioni né copie degli elementi.
+	@param S Set sorgente.
+	@param P Predicato applicato al set sorgente.
+	@return La vista filtrata del set sorgente.
+**/
+template <typename T, typename... Params, typename Pred>
+filtered_view<set<T, Params...>, Pred> filter_out_view(const set<T, Params...> &S, const Pred P){
+	return filtered_view<set<T, Params...>, Pred>(S, P);
+}
+
+/**
+	@brief Operatore di stream
+
+	Permette di spedire su uno stream di output il contenuto di una vista filtrata.
+	@param os stream di output
+	@param view Vista sorgente i cui elementi verranno spediti sullo stream.
+	@return Il riferimento allo stream di output.
+**/
+template <typename S, typename Pred>
+std::ostream &operator<<(std::ostream &os, const filtered_view<S, Pred> &view){
+
+	typename filtered_view<S, Pred>::const_iterator i, ie;
+
+	for(i=view.begin(), ie=view.end(); i!=ie; ++i)
+		os << *i << " ";
+	return os;
+}
+
 /**
 	@brief Concatenzione di due set
 
@@ -495,20 +3936,92 @@ set<T, Eql> filter_out(const set<T, Eql> &S, const Pred P){
 	in caso di elemento già esistente nel set.
 	@return Il set risultato della concatenzione dei due set sorgenti.
 **/
-template <typename T, typename Eql>
-set<T, Eql> operator+(const set<T, Eql> &first, const set<T, Eql> &second){
+template <typename T, typename... P>
+set<T, P...> operator+(const set<T, P...> &first, const set<T, P...> &second){
 
-	typename set<T, Eql>::const_iterator i, ie;
-	set<T, Eql> new_set(first);
+	typename set<T, P...>::const_iterator i, ie;
+	set<T, P...> new_set(first);
 
-	for(i=second.begin(), ie=second.end(); i!=ie; ++i){
+	for(i=second.begin(), ie=second.end(); i!=ie; ++i)
 
-		try{
-			new_set.add(*i);
-		}catch(already_existing_exception e){		
-			throw e;			
-		}
-	}
+		if(!new_set.try_add(*i))
+			throw already_existing_exception();
+
+	return new_set;
+}
+
+/**
+	@brief Unione di due set
+
+	Funzione globale che ritorna un set contenente gli elementi di first seguiti,
+	nel loro ordine, da quelli di second non presenti in first.
+	A differenza di operator+ gli elementi comuni non causano eccezioni.
+	Con l'indice hash il costo atteso è O(N+M).
+	@param first Primo set sorgente.
+	@param second Secondo set sorgente.
+	@return Il set unione dei due set sorgenti.
+**/
+template <typename T, typename... P>
+set<T, P...> set_union(const set<T, P...> &first, const set<T, P...> &second){
+
+	set<T, P...> new_set(first);
+	new_set |= second;
+	return new_set;
+}
+
+/**
+	@brief Intersezione di due set
+
+	Funzione globale che ritorna un set contenente gli elementi comuni ai due set.
+	Viene scandito il più piccolo dei due set cercandone gli elementi nel più grande,
+	quindi il risultato segue l'ordine del set più piccolo (di first a parità
+	di dimensione). Con l'indice hash il costo atteso è O(min(N, M)).
+	@param first Primo set sorgente.
+	@param second Secondo set sorgente.
+	@return Il set intersezione dei due set sorgenti.
+**/
+template <typename T, typename... P>
+set<T, P...> set_intersection(const set<T, P...> &first, const set<T, P...> &second){
+
+	const bool first_smaller = first.size() <= second.size();
+	set<T, P...> new_set(first_smaller ? first : second);
+	new_set &= first_smaller ? second : first;
+	return new_set;
+}
+
+/**
+	@brief Differenza di due set
+
+	Funzione globale che ritorna un set contenente, nel loro ordine,
+	gli elementi di first non presenti in second.
+	Con l'indice hash il costo atteso è O(N).
+	@param first Set sorgente.
+	@param second Set i cui elementi vengono esclusi dal risultato.
+	@return Il set differenza dei due set sorgenti.
+**/
+template <typename T, typename... P>
+set<T, P...> set_difference(const set<T, P...> &first, const set<T, P...> &second){
+
+	set<T, P...> new_set(first);
+	new_set -= second;
+	return new_set;
+}
+
+/**
+	@brief Differenza simmetrica di due set
+
+	Funzione globale che ritorna un set contenente gli elementi di first non presenti
+	in second, seguiti da quelli di second non presenti in first.
+	Con l'indice hash il costo atteso è O(N+M).
+	@param first Primo set sorgente.
+	@param second Secondo set sorgente.
+	@return Il set differenza simmetrica dei due set sorgenti.
+**/
+template <typename T, typename... P>
+set<T, P...> set_symmetric_difference(const set<T, P...> &first, const set<T, P...> &second){
+
+	set<T, P...> new_set(first);
+	new_set ^= second;
 	return new_set;
 }
 #endif
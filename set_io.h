@@ -0,0 +1,994 @@
+#ifndef SET_IO_H
+#define SET_IO_H
+
+#include "set.h"	//set, set_access
+#include <istream>	//istream
+#include <ostream>	//ostream
+#include <string>	//string
+#include <vector>	//vector
+#include <cstring>	//memcpy, memcmp
+#include <cstdint>	//uint32_t, uint64_t
+#include <type_traits>	//is_trivially_copyable
+#include <iterator>	//forward_iterator_tag
+#include <charconv>	//to_chars
+#include <sstream>	//ostringstream
+#include <cstdio>	//FILE, fwrite
+#include <cerrno>	//errno, EINTR
+#include <stdexcept>	//length_error
+#include <limits>	//numeric_limits
+#include <system_error>	//errc
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>	//mmap
+#include <sys/stat.h>	//fstat
+#include <fcntl.h>	//open
+#include <unistd.h>	//close, write
+#endif
+
+/**
+	@file set_io.h
+	@brief Dichiarazione del formato binario dei set, della scrittura bufferizzata e della classe mapped_set
+**/
+
+/**
+	@brief Dichiarazione dell'eccezione set_file_exception
+
+	L'eccezione viene lanciata quando un file (o uno stream) non contiene
+	un set nel formato binario atteso, oppure quando la lettura o la
+	scrittura non vanno a buon fine.
+**/
+class set_file_exception{};
+
+/**
+	@brief Codifica binaria di un elemento
+
+	Struttura che definisce come un elemento di tipo T viene scritto nel formato binario.
+	Deve fornire:
+	- static void encode(std::string &out, const T &v): accoda a out la codifica di v;
+	- static T decode(const char *data, std::size_t size): ricostruisce l'elemento
+	  dai size byte della sua codifica.
+	Sono già definite le codifiche dei tipi trivially copyable (copia dei byte)
+	e di std::string; per gli altri tipi va definita una specializzazione,
+	eventualmente usando codec_put e codec_reader.
+**/
+template <typename T, typename = void>
+struct element_codec;
+
+template <typename T>
+struct element_codec<T, typename std::enable_if<std::is_trivially_copyable<T>::value>::type>{
+
+	static void encode(std::string &out, const T &v){
+		out.append(reinterpret_cast<const char *>(&v), sizeof(T));
+	}
+
+	static T decode(const char *data, std::size_t size){
+		if(size != sizeof(T))
+			throw set_file_exception();
+		alignas(T) unsigned char raw[sizeof(T)];
+		std::memcpy(raw, data, sizeof(T));
+		return *reinterpret_cast<const T *>(raw);
+	}
+};
+
+template <>
+struct element_codec<std::string>{
+
+	static void encode(std::string &out, const std::string &v){
+		out.append(v);
+	}
+
+	static std::string decode(const char *data, std::size_t size){
+		return std::string(data, size);
+	}
+};
+
+/**
+	@brief Accoda la codifica di un campo
+
+	Per i campi di lunghezza variabile (es. stringhe) scrive prima la
+	lunghezza su 32 bit, così che codec_reader possa separarli.
+	@param out Buffer di destinazione.
+	@param v Campo da codificare.
+**/
+template <typename T>
+void codec_put(std::string &out, const T &v){
+	element_codec<T>::encode(out, v);
+}
+
+inline void codec_put(std::string &out, const std::string &v){
+	codec_put(out, static_cast<std::uint32_t>(v.size()));
+	out.append(v);
+}
+
+/**
+	@brief Lettura sequenziale dei campi di una codifica
+
+	Classe che legge in ordine i campi scritti con codec_put,
+	controllando di non superare la fine della codifica.
+**/
+class codec_reader{
+	const char *_data;	///< Prossimo byte da leggere
+	const char *_end;	///< Fine della codifica
+
+public:
+	/**
+		@brief Costruttore secondario
+
+		@param data Inizio della codifica.
+		@param size Numero di byte della codifica.
+	**/
+	codec_reader(const char *data, std::size_t size) : _data(data), _end(data + size) {}
+
+	/**
+		@brief Legge un campo di dimensione fissa
+
+		@return Il campo letto.
+		@throw set_file_exception Se la codifica è troppo corta.
+	**/
+	template <typename T>
+	T get(void){
+		if(static_cast<std::size_t>(_end - _data) < sizeof(T))
+			throw set_file_exception();
+		T v = element_codec<T>::decode(_data, sizeof(T));
+		_data += sizeof(T);
+		return v;
+	}
+
+	/**
+		@brief Legge una stringa scritta con codec_put
+
+		@return La stringa letta.
+		@throw set_file_exception Se la codifica è troppo corta.
+	**/
+	std::string get_string(void){
+		std::uint32_t size = get<std::uint32_t>();
+		if(static_cast<std::size_t>(_end - _data) < size)
+			throw set_file_exception();
+		std::string v(_data, size);
+		_data += size;
+		return v;
+	}
+};
+
+namespace set_detail{
+
+/**
+	@brief Intestazione del formato binario
+
+	Il file è composto da: intestazione, codifiche degli elementi una dopo l'altra
+	(nell'ordine di iterazione del set), tabella degli offset delle codifiche
+	(count + 1 valori), e, se il set usa l'indice hash, gli hash degli elementi
+	e una tabella ad indirizzamento aperto di posizioni (posizione + 1, 0 se vuota).
+	Le sezioni successive alle codifiche sono allineate a 8 byte.
+	I valori sono scritti nell'ordine dei byte della macchina.
+**/
+struct file_header{
+	char magic[8];	///< "SETFILE" seguito da 0
+	std::uint32_t version;	///< Versione del formato
+	std::uint32_t endian;	///< 0x01020304 nell'ordine dei byte di chi ha scritto il file
+	std::uint32_t flags;	///< Bit 0: presenza dell'indice hash
+	std::uint32_t reserved;	///< Riservato, 0
+	std::uint64_t count;	///< Numero di elementi
+	std::uint64_t data;	///< Posizione della prima codifica
+	std::uint64_t data_size;	///< Dimensione totale delle codifiche
+	std::uint64_t offsets;	///< Posizione della tabella degli offset
+	std::uint64_t hashes;	///< Posizione degli hash, 0 senza indice
+	std::uint64_t slots;	///< Posizione della tabella dell'indice, 0 senza indice
+	std::uint64_t slot_count;	///< Numero di celle dell'indice (potenza di 2)
+};
+
+static const std::uint32_t file_version = 1;	///< Versione corrente del formato
+static const std::uint32_t file_endian = 0x01020304;	///< Marcatore dell'ordine dei byte
+static const std::uint32_t file_indexed = 1;	///< Flag: il file contiene l'indice hash
+static const std::uint64_t file_max_count = 0xfffffffe;	///< Massimo numero di elementi: l'indice riferisce posizione + 1 a 32 bit
+
+/**
+	@brief Posizione iniziale di un hash nell'indice del file
+
+	@param hash Hash del valore.
+	@param shift 64 - log2(numero di celle).
+	@return L'indice della prima cella da ispezionare.
+**/
+inline std::size_t file_home(std::uint64_t hash, unsigned int shift){
+	return static_cast<std::size_t>((hash * 11400714819323198485ull) >> shift);
+}
+
+/**
+	@brief Verifica un'intestazione
+
+	@param h Intestazione letta.
+	@throw set_file_exception Se l'intestazione non è valida.
+**/
+inline void check_header(const file_header &h){
+	if(std::memcmp(h.magic, "SETFILE", 8) != 0 || h.version != file_version ||
+		h.endian != file_endian || h.count > file_max_count)
+		throw set_file_exception();
+}
+
+/**
+	@brief Scrive dei byte su uno stream
+
+	@throw set_file_exception Se la scrittura non va a buon fine.
+**/
+inline void write_bytes(std::ostream &os, const void *data, std::size_t size){
+	if(!os.write(static_cast<const char *>(data), static_cast<std::streamsize>(size)))
+		throw set_file_exception();
+}
+
+/**
+	@brief Legge dei byte da uno stream
+
+	@throw set_file_exception Se lo stream termina prima.
+**/
+inline void read_bytes(std::istream &is, void *data, std::size_t size){
+	if(!is.read(static_cast<char *>(data), static_cast<std::streamsize>(size)))
+		throw set_file_exception();
+}
+
+/**
+	@brief Verifica che una sezione sia contenuta nello stream
+
+	@param position Inizio della sezione, rispetto all'inizio del set.
+	@param size Dimensione della sezione.
+	@param length Byte disponibili dall'inizio del set alla fine dello stream.
+	@throw set_file_exception Se la sezione esce dallo stream.
+**/
+inline void check_stream_section(std::uint64_t position, std::uint64_t size, std::uint64_t length){
+	if(position > length || size > length - position)
+		throw set_file_exception();
+}
+
+} // namespace set_detail
+
+/**
+	@brief Salva un set nel formato binario
+
+	Scrive gli elementi nell'ordine di iterazione, codificati con element_codec<T>.
+	Se il set usa l'indice hash vengono salvati anche gli hash e un indice, che
+	permettono a mapped_set di cercare gli elementi senza leggere l'intero file.
+	Lo stream deve consentire il riposizionamento (es. std::ofstream aperto in
+	modalità binaria, std::stringstream).
+	Il formato contiene al più 2^32 - 2 elementi.
+	@param os Stream di output.
+	@param S Set da salvare.
+	@throw set_file_exception Se la scrittura non va a buon fine.
+	@throw std::length_error Se S ha più di 2^32 - 2 elementi.
+**/
+template <typename T, typename... P>
+void save_binary(std::ostream &os, const set<T, P...> &S){
+
+	typedef set<T, P...> set_type;
+	if(S.size() > set_detail::file_max_count)
+		throw std::length_error("save_binary: too many elements for the file format");
+	const bool indexed = set_detail::set_access::hashed<set_type>();
+
+	std::streampos start = os.tellp();
+	set_detail::file_header header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, "SETFILE", 8);
+	header.version = set_detail::file_version;
+	header.endian = set_detail::file_endian;
+	header.flags = indexed ? set_detail::file_indexed : 0;
+	header.count = S.size();
+	header.data = sizeof(header);
+	set_detail::write_bytes(os, &header, sizeof(header));
+
+	std::vector<std::uint64_t> offsets;
+	std::vector<std::uint64_t> hashes;
+	offsets.reserve(S.size() + 1);
+	if(indexed)
+		hashes.reserve(S.size());
+
+	std::string buffer;
+	std::uint64_t written = 0;
+	for(typename set_type::const_iterator i = S.begin(), ie = S.end(); i != ie; ++i){
+		buffer.clear();
+		element_codec<T>::encode(buffer, *i);
+		offsets.push_back(written);
+		if(indexed)
+			hashes.push_back(set_detail::set_access::hash(S, *i));
+		set_detail::write_bytes(os, buffer.data(), buffer.size());
+		written += buffer.size();
+	}
+	offsets.push_back(written);
+	header.data_size = written;
+
+	const char padding[8] = {0};
+	std::uint64_t position = header.data + written;
+	set_detail::write_bytes(os, padding, (8 - position % 8) % 8);
+	position += (8 - position % 8) % 8;
+
+	header.offsets = position;
+	set_detail::write_bytes(os, offsets.data(), offsets.size() * sizeof(std::uint64_t));
+	position += offsets.size() * sizeof(std::uint64_t);
+
+	if(indexed){
+		std::uint64_t capacity = 8;
+		unsigned int shift = 61;
+		while(capacity < hashes.size() * 2){
+			capacity <<= 1;
+			shift--;
+		}
+
+		std::vector<std::uint32_t> slots(capacity, 0);
+		for(std::size_t k = 0; k < hashes.size(); ++k){
+			std::size_t j = set_detail::file_home(hashes[k], shift);
+			while(slots[j] != 0)
+				j = (j + 1) & (capacity - 1);
+			slots[j] = static_cast<std::uint32_t>(k + 1);
+		}
+
+		header.hashes = position;
+		set_detail::write_bytes(os, hashes.data(), hashes.size() * sizeof(std::uint64_t));
+		position += hashes.size() * sizeof(std::uint64_t);
+
+		header.slots = position;
+		header.slot_count = capacity;
+		set_detail::write_bytes(os, slots.data(), slots.size() * sizeof(std::uint32_t));
+		position += slots.size() * sizeof(std::uint32_t);
+	}
+
+	std::streampos end = os.tellp();
+	if(!os.seekp(start))
+		throw set_file_exception();
+	set_detail::write_bytes(os, &header, sizeof(header));
+	if(!os.seekp(end))
+		throw set_file_exception();
+}
+
+/**
+	@brief Carica un set salvato nel formato binario
+
+	Gli elementi vengono decodificati con element_codec<T> e aggiunti in coda;
+	ogni elemento viene cercato prima dell'aggiunta, con l'indice hash del set
+	se presente, in modo che un file danneggiato non possa introdurre duplicati.
+	In caso di eccezione S non viene modificato.
+	@param is Stream di input.
+	@param S Set in cui caricare gli elementi (il contenuto precedente viene sostituito).
+	@throw set_file_exception Se lo stream non contiene un set valido
+	o contiene elementi duplicati.
+**/
+template <typename T, typename... P>
+void load_binary(std::istream &is, set<T, P...> &S){
+
+	std::streampos start = is.tellg();
+	set_detail::file_header header;
+	set_detail::read_bytes(is, &header, sizeof(header));
+	set_detail::check_header(header);
+
+	//le sezioni vengono verificate sulla lunghezza dello stream prima di allocare
+	if(!is.seekg(0, std::ios::end))
+		throw set_file_exception();
+	std::streampos stream_end = is.tellg();
+	if(stream_end == std::streampos(-1) || stream_end < start)
+		throw set_file_exception();
+	std::uint64_t length = static_cast<std::uint64_t>(stream_end - start);
+	if(header.data > header.offsets || header.data_size > header.offsets - header.data)
+		throw set_file_exception();
+	set_detail::check_stream_section(header.data, header.data_size, length);
+	set_detail::check_stream_section(header.offsets, (header.count + 1) * sizeof(std::uint64_t), length);
+	if(header.slots != 0){
+		if(header.slot_count > length / sizeof(std::uint32_t))
+			throw set_file_exception();
+		set_detail::check_stream_section(header.slots, header.slot_count * sizeof(std::uint32_t), length);
+	}
+
+	std::string data(static_cast<std::size_t>(header.data_size), '\0');
+	if(!is.seekg(start + static_cast<std::streamoff>(header.data)))
+		throw set_file_exception();
+	set_detail::read_bytes(is, &data[0], data.size());
+
+	std::vector<std::uint64_t> offsets(static_cast<std::size_t>(header.count + 1));
+	if(!is.seekg(start + static_cast<std::streamoff>(header.offsets)))
+		throw set_file_exception();
+	set_detail::read_bytes(is, offsets.data(), offsets.size() * sizeof(std::uint64_t));
+
+	set<T, P...> result;
+	set_detail::set_access::reserve(result, header.count);
+	for(std::size_t k = 0; k < header.count; ++k){
+		if(offsets[k] > offsets[k + 1] || offsets[k + 1] > header.data_size)
+			throw set_file_exception();
+		T v = element_codec<T>::decode(data.data() + offsets[k], offsets[k + 1] - offsets[k]);
+		std::size_t h = set_detail::set_access::hash(result, v);
+		if(set_detail::set_access::contains(result, v, h))
+			throw set_file_exception();
+		set_detail::set_access::append(result, std::move(v), h);
+	}
+
+	std::uint64_t end = header.slots != 0 ? header.slots + header.slot_count * sizeof(std::uint32_t)
+		: header.offsets + offsets.size() * sizeof(std::uint64_t);
+	if(!is.seekg(start + static_cast<std::streamoff>(end)))
+		throw set_file_exception();
+	S.swap(result);
+}
+
+/**
+	@brief Buffer di scrittura
+
+	Classe che accumula il testo in un buffer di 64KB e lo scrive sul
+	FILE* o sul file descriptor di destinazione solo quando il buffer è pieno
+	o con flush(), evitando la formattazione per elemento di std::ostream.
+	Il distruttore non svuota il buffer: va chiamato flush().
+**/
+class output_buffer{
+
+	static const std::size_t capacity = 1 << 16;	///< Dimensione del buffer
+
+	std::FILE *_file;	///< Destinazione, 0 se si scrive su _fd
+	int _fd;	///< File descriptor di destinazione
+	std::size_t _size;	///< Byte presenti nel buffer
+	std::vector<char> _data;	///< Buffer
+
+public:
+	/**
+		@brief Costruttore secondario
+
+		@param file FILE* su cui scrivere.
+	**/
+	explicit output_buffer(std::FILE *file) : _file(file), _fd(-1), _size(0), _data(capacity) {}
+
+	/**
+		@brief Costruttore secondario
+
+		@param fd File descriptor su cui scrivere.
+	**/
+	explicit output_buffer(int fd) : _file(0), _fd(fd), _size(0), _data(capacity) {}
+
+	output_buffer(const output_buffer &other) = delete;
+	output_buffer &operator=(const output_buffer &other) = delete;
+
+	/**
+		@brief Spazio libero in coda al buffer
+
+		Svuota il buffer se contiene meno di n byte liberi.
+		@pre n non deve superare la dimensione del buffer.
+		@param n Numero di byte richiesti.
+		@return Il puntatore al primo byte libero; i byte scritti vanno confermati con commit().
+	**/
+	char *reserve(std::size_t n){
+		assert(n <= capacity);
+		if(capacity - _size < n)
+			flush();
+		return _data.data() + _size;
+	}
+
+	/**
+		@brief Conferma i byte scritti dopo reserve()
+
+		@param n Numero di byte scritti.
+	**/
+	void commit(std::size_t n){
+		_size += n;
+	}
+
+	/**
+		@brief Accoda un carattere
+
+		@param c Carattere da accodare.
+	**/
+	void put(char c){
+		*reserve(1) = c;
+		++_size;
+	}
+
+	/**
+		@brief Accoda una sequenza di byte
+
+		@param data Byte da accodare.
+		@param size Numero di byte.
+	**/
+	void append(const char *data, std::size_t size){
+		while(size > 0){
+			std::size_t n = size < capacity ? size : capacity;
+			std::memcpy(reserve(n), data, n);
+			_size += n;
+			data += n;
+			size -= n;
+		}
+	}
+
+	/**
+		@brief Scrive il contenuto del buffer sulla destinazione
+
+		@throw set_file_exception Se la scrittura non va a buon fine.
+	**/
+	void flush(void){
+
+		const char *data = _data.data();
+		std::size_t size = _size;
+		_size = 0;
+
+		if(_file != 0){
+			if(std::fwrite(data, 1, size, _file) != size)
+				throw set_file_exception();
+			return;
+		}
+
+#if defined(__unix__) || defined(__APPLE__)
+		while(size > 0){
+			ssize_t n = ::write(_fd, data, size);
+			if(n < 0){
+				if(errno == EINTR)
+					continue;
+				throw set_file_exception();
+			}
+			data += n;
+			size -= static_cast<std::size_t>(n);
+		}
+#else
+		if(size > 0)
+			throw set_file_exception();
+#endif
+	}
+};
+
+/**
+	@brief Formattazione testuale di un elemento
+
+	Funtore usato da write_to per scrivere un elemento su un output_buffer.
+	Il testo prodotto è lo stesso di operator<< con le impostazioni predefinite
+	dello stream: gli interi e i floating point vengono convertiti con std::to_chars
+	(questi ultimi in formato generale con 6 cifre significative), le stringhe
+	vengono copiate; per gli altri tipi si ricorre a operator<< su uno stream di appoggio.
+	Per un formato diverso si può passare a write_to un funtore con la stessa firma.
+	Se std::to_chars non riesce a convertire il valore viene lanciata set_file_exception.
+**/
+template <typename T, typename = void>
+struct element_formatter{
+
+	std::ostringstream _stream;	///< Stream di appoggio, riusato tra gli elementi
+
+	void operator()(output_buffer &out, const T &v){
+		_stream.str(std::string());
+		_stream << v;
+		const std::string &text = _stream.str();
+		out.append(text.data(), text.size());
+	}
+};
+
+template <typename T>
+struct element_formatter<T, typename std::enable_if<std::is_integral<T>::value &&
+	!std::is_same<T, bool>::value && !std::is_same<T, char>::value &&
+	!std::is_same<T, signed char>::value && !std::is_same<T, unsigned char>::value>::type>{
+
+	static const std::size_t length = std::numeric_limits<T>::digits10 + 3;	///< Cifre, segno e una cifra parziale
+
+	void operator()(output_buffer &out, T v) const{
+		char *first = out.reserve(length);
+		std::to_chars_result result = std::to_chars(first, first + length, v);
+		if(result.ec != std::errc())
+			throw set_file_exception();
+		out.commit(result.ptr - first);
+	}
+};
+
+template <typename T>
+struct element_formatter<T, typename std::enable_if<std::is_floating_point<T>::value>::type>{
+
+	void operator()(output_buffer &out, T v) const{
+		char *first = out.reserve(64);
+		std::to_chars_result result = std::to_chars(first, first + 64, v, std::chars_format::general, 6);
+		if(result.ec != std::errc())
+			throw set_file_exception();
+		out.commit(result.ptr - first);
+	}
+};
+
+template <>
+struct element_formatter<std::string>{
+
+	void operator()(output_buffer &out, const std::string &v) const{
+		out.append(v.data(), v.size());
+	}
+};
+
+/**
+	@brief Scrive un set su un buffer di output
+
+	Scrive gli elementi nell'ordine di iterazione, ciascuno seguito da uno spazio
+	come operator<<, e svuota il buffer al termine.
+	@param out Buffer di destinazione.
+	@param S Set da scrivere.
+	@param format Funtore che formatta un elemento su un output_buffer.
+	@throw set_file_exception Se la scrittura non va a buon fine.
+**/
+template <typename T, typename... P, typename Formatter>
+void write_to(output_buffer &out, const set<T, P...> &S, Formatter &format){
+
+	typename set<T, P...>::const_iterator i, ie;
+
+	for(i=S.begin(), ie=S.end(); i!=ie; ++i){
+		format(out, *i);
+		out.put(' ');
+	}
+	out.flush();
+}
+
+/**
+	@brief Scrive un set su un FILE*
+
+	Il FILE* non viene svuotato: i dati possono restare nel suo buffer fino a fflush.
+	@param file FILE* di destinazione.
+	@param S Set da scrivere.
+	@param format Funtore che formatta un elemento su un output_buffer.
+	@throw set_file_exception Se la scrittura non va a buon fine.
+**/
+template <typename T, typename... P, typename Formatter>
+void write_to(std::FILE *file, const set<T, P...> &S, Formatter format){
+	output_buffer out(file);
+	write_to(out, S, format);
+}
+
+/**
+	@brief Scrive un set su un FILE* con la formattazione predefinita
+
+	@param file FILE* di destinazione.
+	@param S Set da scrivere.
+	@throw set_file_exception Se la scrittura non va a buon fine.
+**/
+template <typename T, typename... P>
+void write_to(std::FILE *file, const set<T, P...> &S){
+	write_to(file, S, element_formatter<T>());
+}
+
+/**
+	@brief Scrive un set su un file descriptor
+
+	@param fd File descriptor di destinazione.
+	@param S Set da scrivere.
+	@param format Funtore che formatta un elemento su un output_buffer.
+	@throw set_file_exception Se la scrittura non va a buon fine.
+**/
+template <typename T, typename... P, typename Formatter>
+void write_to(int fd, const set<T, P...> &S, Formatter format){
+	output_buffer out(fd);
+	write_to(out, S, format);
+}
+
+/**
+	@brief Scrive un set su un file descriptor con la formattazione predefinita
+
+	@param fd File descriptor di destinazione.
+	@param S Set da scrivere.
+	@throw set_file_exception Se la scrittura non va a buon fine.
+**/
+template <typename T, typename... P>
+void write_to(int fd, const set<T, P...> &S){
+	write_to(fd, S, element_formatter<T>());
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+
+/**
+	@brief Set in sola lettura mappato in memoria
+
+	Classe che dà accesso ad un set salvato con save_binary mappando il file in
+	memoria, senza leggerlo né decodificarlo per intero: la ricerca di un elemento
+	usa l'indice hash salvato e decodifica solo gli elementi con lo stesso hash,
+	l'accesso per posizione decodifica solo l'elemento richiesto.
+	Le pagine del file vengono caricate dal sistema operativo al primo accesso.
+	Con Hash uguale a no_hash, o se il file non contiene l'indice, la ricerca
+	decodifica gli elementi uno alla volta.
+	L'indice del file riferisce gli elementi con celle a 32 bit, per cui il set
+	salvato contiene al più 2^32 - 2 elementi (save_binary rifiuta set più grandi).
+	@param T Tipo degli elementi.
+	@param Eql Funtore per l'uguaglianza tra elementi.
+	@param Hash Funtore di hash, che deve essere lo stesso usato dal set salvato.
+**/
+template <typename T, typename Eql, typename Hash = no_hash>
+class mapped_set{
+
+	typedef std::size_t size_type;	///< Definzione del tipo corrispondente a size
+
+	const char *_base;	///< Inizio del file mappato
+	std::size_t _length;	///< Dimensione del file
+	size_type _count;	///< Numero di elementi
+	const char *_data;	///< Prima codifica
+	const std::uint64_t *_offsets;	///< Offset delle codifiche
+	const std::uint64_t *_hashes;	///< Hash degli elementi, 0 senza indice
+	const std::uint32_t *_slots;	///< Celle dell'indice, 0 senza indice
+	std::size_t _slot_mask;	///< Numero di celle dell'indice - 1
+	unsigned int _shift;	///< 64 - log2(numero di celle)
+	Eql _equal;	///< Funtore per l'uguaglianza
+	Hash _hasher;	///< Funtore di hash
+
+	/**
+		@brief Verifica che una sezione sia contenuta nel file
+
+		@param position Inizio della sezione.
+		@param size Dimensione della sezione.
+		@param align Allineamento richiesto.
+		@throw set_file_exception Se la sezione esce dal file o non è allineata.
+	**/
+	void check_section(std::uint64_t position, std::uint64_t size, std::uint64_t align) const{
+		if(position % align != 0 || position > _length || size > _length - position)
+			throw set_file_exception();
+	}
+
+	/**
+		@brief Verifica l'intestazione e le tabelle del file
+
+		Gli offset e le celle dell'indice vengono controllati una volta sola,
+		in modo che le ricerche successive non possano uscire dal file.
+		@throw set_file_exception Se il file non contiene un set valido.
+	**/
+	void validate(void){
+
+		if(_length < sizeof(set_detail::file_header))
+			throw set_file_exception();
+
+		set_detail::file_header header;
+		std::memcpy(&header, _base, sizeof(header));
+		set_detail::check_header(header);
+
+		_count = static_cast<size_type>(header.count);
+		check_section(header.data, header.data_size, 1);
+		check_section(header.offsets, (header.count + 1) * sizeof(std::uint64_t), 8);
+		_data = _base + header.data;
+		_offsets = reinterpret_cast<const std::uint64_t *>(_base + header.offsets);
+
+		for(size_type k = 0; k < _count; ++k)
+			if(_offsets[k] > _offsets[k + 1])
+				throw set_file_exception();
+		if(_offsets[_count] > header.data_size)
+			throw set_file_exception();
+
+		if((header.flags & set_detail::file_indexed) != 0 && !std::is_same<Hash, no_hash>::value){
+			std::uint64_t slots = header.slot_count;
+			//save_binary scrive almeno 2 celle per elemento: con una tabella piena
+			//la ricerca di un elemento assente non terminerebbe
+			if(slots < 8 || (slots & (slots - 1)) != 0 || slots / 2 < header.count)
+				throw set_file_exception();
+			check_section(header.hashes, header.count * sizeof(std::uint64_t), 8);
+			check_section(header.slots, slots * sizeof(std::uint32_t), 4);
+
+			_hashes = reinterpret_cast<const std::uint64_t *>(_base + header.hashes);
+			_slots = reinterpret_cast<const std::uint32_t *>(_base + header.slots);
+			_slot_mask = static_cast<std::size_t>(slots - 1);
+			_shift = 64;
+			for(std::uint64_t c = slots; c > 1; c >>= 1)
+				_shift--;
+
+			std::size_t empty = 0;
+			for(std::size_t j = 0; j <= _slot_mask; ++j){
+				if(_slots[j] > _count)
+					throw set_file_exception();
+				empty += (_slots[j] == 0);
+			}
+			if(empty == 0)
+				throw set_file_exception();
+		}
+	}
+
+	/**
+		@brief Decodifica un elemento
+
+		@param k Posizione dell'elemento.
+		@return L'elemento decodificato.
+	**/
+	T decode(size_type k) const{
+		return element_codec<T>::decode(_data + _offsets[k], static_cast<std::size_t>(_offsets[k + 1] - _offsets[k]));
+	}
+
+public:
+	/**
+		@brief Costruttore secondario
+
+		Costruttore secondario. Mappa in memoria un file scritto da save_binary.
+		@param path Percorso del file.
+		@throw set_file_exception Se il file non può essere aperto o non contiene un set valido.
+	**/
+	explicit mapped_set(const char *path) : _base(0), _length(0), _count(0), _data(0), _offsets(0),
+		_hashes(0), _slots(0), _slot_mask(0), _shift(64) {
+
+		int fd = ::open(path, O_RDONLY);
+		if(fd < 0)
+			throw set_file_exception();
+
+		struct stat st;
+		if(::fstat(fd, &st) != 0 || st.st_size <= 0){
+			::close(fd);
+			throw set_file_exception();
+		}
+
+		_length = static_cast<std::size_t>(st.st_size);
+		void *base = ::mmap(0, _length, PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd);
+		if(base == MAP_FAILED)
+			throw set_file_exception();
+		_base = static_cast<const char *>(base);
+
+		try{
+			validate();
+		}catch(...){
+			::munmap(const_cast<char *>(_base), _length);
+			throw;
+		}
+	}
+
+	mapped_set(const mapped_set &other) = delete;
+	mapped_set &operator=(const mapped_set &other) = delete;
+
+	/**
+		@brief Distruttore
+
+		Rimuove la mappatura del file.
+	**/
+	~mapped_set(){
+		::munmap(const_cast<char *>(_base), _length);
+	}
+
+	/**
+		@brief Numero di elementi nel set
+
+		@return Il numero di elementi nel set.
+	**/
+	size_type size(void) const{
+		return _count;
+	}
+
+	/**
+		@brief Elemento i-esimo
+
+		@param i Posizione dell'elemento, nell'ordine del set salvato.
+		@return Una copia decodificata dell'elemento.
+	**/
+	T operator[](size_type i) const{
+		assert(i < _count);
+		return decode(i);
+	}
+
+	/**
+		@brief Verifica la presenza di un elemento
+
+		@param v Elemento da cercare.
+		@return true se l'elemento è presente nel set.
+	**/
+	bool contains(const T &v) const{
+
+		if constexpr (!std::is_same<Hash, no_hash>::value){
+			if(_slots != 0){
+				std::uint64_t h = _hasher(v);
+				for(std::size_t j = set_detail::file_home(h, _shift); _slots[j] != 0; j = (j + 1) & _slot_mask){
+					size_type k = _slots[j] - 1;
+					if(_hashes[k] == h && _equal(decode(k), v))
+						return true;
+				}
+				return false;
+			}
+		}
+
+		for(size_type k = 0; k < _count; ++k)
+			if(_equal(decode(k), v))
+				return true;
+		return false;
+	}
+
+	/**
+		@brief Definizione della classe const_iterator
+
+		Classe che implementa iteratori di tipo costante utilizzabili nella classe
+		mapped_set. Il dereferenziamento decodifica l'elemento e ne restituisce una copia.
+	**/
+	class const_iterator {
+		const mapped_set *s;
+		size_type k;
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef T                         value_type;
+		typedef ptrdiff_t                 difference_type;
+		typedef const T*                  pointer;
+		typedef T                         reference;
+
+		/**
+			@brief Costruttore di default
+
+			Costruttore di default per istanziare un const_iterator.
+		**/
+		const_iterator() : s(0), k(0){}
+
+		/**
+			@brief Operatore di dereferenziamento
+
+			Operatore di dereferenziamento. Ritorna il dato riferito dall'iteratore.
+			@return Una copia decodificata del dato riferito dall'iteratore.
+		**/
+		reference operator*() const {
+			return s->decode(k);
+		}
+
+		/**
+			@brief Operatore di iterazione post-incremento
+
+			Operatore di iterazione post-incremento. Incrementa il const_iteratore
+			ma ne ritorna la copia non iterata.
+			@return La copia del const_iterator.
+		**/
+		const_iterator operator++(int) {
+			const_iterator tmp(*this);
+			++k;
+			return tmp;
+		}
+
+		/**
+			@brief Operatore di iterazione pre-incremento
+
+			Operatore di iterazione pre-incremento. Incrementa il const_iteratore
+			ma ne ritorna il riferimento
+			@return Il riferimento al const_iterator.
+		**/
+		const_iterator& operator++() {
+			++k;
+			return *this;
+		}
+
+		/**
+			@brief Operatore di uguaglianza
+
+			Operatore di uguaglianza. Esegue una comparazione tra due const_iterator,
+			se sono uguali restituisce true, altrimenti restituisce false.
+			@param other Il const_iterator con cui effettuare la comparazione.
+			@return Il risultato della comparazione di due const_iterator.
+		**/
+		bool operator==(const const_iterator &other) const {
+			return (k==other.k);
+		}
+
+		/**
+			@brief Operatore di diversità
+
+			Operatore di diversità. Esegue una comparazione tra due const_iterator,
+			se sono diversi restituisce true, altrimenti restituisce false.
+			@param other Il const_iterator con cui effettuare la comparazione.
+			@return Il risultato della comparazione di due const_iterator.
+		**/
+		bool operator!=(const const_iterator &other) const {
+			return (k!=other.k);
+		}
+
+	private:
+
+		friend class mapped_set;
+		const_iterator(const mapped_set *ss, size_type kk) : s(ss), k(kk){}
+	}; // classe const_iterator
+
+	/**
+		@brief Iteratore all'inizio della sequenza di dati
+
+		@return L'iteratore all'inizio della sequenza di dati.
+	**/
+	const_iterator begin() const {
+		return const_iterator(this, 0);
+	}
+
+	/**
+		@brief Iteratore alla fine della sequenza di dati
+
+		@return L'iteratore alla fine della sequenza di dati.
+	**/
+	const_iterator end() const {
+		return const_iterator(this, _count);
+	}
+};
+
+/**
+	@brief Operatore di stream
+
+	Permette di spedire su uno stream di output il contenuto del set mappato.
+	@param os stream di output
+	@param data_set Set sorgente i cui elementi verranno spediti sullo stream.
+	@return Il riferimento allo stream di output.
+**/
+template <typename T, typename Eql, typename Hash>
+std::ostream &operator<<(std::ostream &os, const mapped_set<T, Eql, Hash> &data_set){
+
+	typename mapped_set<T, Eql, Hash>::const_iterator i, ie;
+
+	for(i=data_set.begin(), ie=data_set.end(); i!=ie; ++i)
+		os << *i << " ";
+	return os;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,202 @@
+#ifndef SET_STATS_H
+#define SET_STATS_H
+
+#include <chrono>	//steady_clock
+#include <string>	//string, to_string
+
+/**
+	@file set_stats.h
+	@brief Dichiarazione delle politiche di strumentazione del set
+**/
+
+/**
+	@brief Contatori delle operazioni di un set
+
+	Fotografia dei contatori restituita da set::stats().
+	L'istogramma delle latenze ha un bucket per ogni potenza di 2:
+	il bucket i conta le operazioni durate tra 2^i e 2^(i+1) nanosecondi.
+**/
+struct set_stats{
+	static const unsigned int buckets = 32;	///< Numero di bucket dell'istogramma
+
+	unsigned long long adds;	///< Elementi aggiunti
+	unsigned long long removes;	///< Elementi rimossi
+	unsigned long long lookups;	///< Ricerche, comprese quelle eseguite da add e remove
+	unsigned long long duplicates;	///< Aggiunte rifiutate perché l'elemento era già presente
+	unsigned long long visited;	///< Elementi confrontati dalle ricerche
+	unsigned long long max_visited;	///< Massimo numero di elementi confrontati da una ricerca
+	unsigned long long allocations;	///< Allocazioni del contenitore e dell'indice hash durante le aggiunte
+	unsigned long long samples;	///< Operazioni cronometrate
+	unsigned long long latency[buckets];	///< Istogramma delle latenze campionate
+
+	/**
+		@brief Costruttore di default
+
+		Costruttore di default che azzera i contatori.
+	**/
+	set_stats() : adds(0), removes(0), lookups(0), duplicates(0), visited(0),
+		max_visited(0), allocations(0), samples(0), latency() {}
+};
+
+/**
+	@brief Serializza i contatori in JSON
+
+	@param s Contatori da serializzare.
+	@return Un oggetto JSON con un campo per contatore; l'istogramma è un array
+	di buckets elementi.
+**/
+inline std::string to_json(const set_stats &s){
+
+	std::string out = "{\"adds\": " + std::to_string(s.adds) +
+		", \"removes\": " + std::to_string(s.removes) +
+		", \"lookups\": " + std::to_string(s.lookups) +
+		", \"duplicates\": " + std::to_string(s.duplicates) +
+		", \"visited\": " + std::to_string(s.visited) +
+		", \"max_visited\": " + std::to_string(s.max_visited) +
+		", \"allocations\": " + std::to_string(s.allocations) +
+		", \"samples\": " + std::to_string(s.samples) +
+		", \"latency_ns_log2\": [";
+
+	for(unsigned int i = 0; i < set_stats::buckets; ++i){
+		if(i > 0)
+			out += ", ";
+		out += std::to_string(s.latency[i]);
+	}
+	return out + "]}";
+}
+
+/**
+	@brief Politica di strumentazione nulla
+
+	Politica di default del set: tutti i metodi sono vuoti e vengono eliminati
+	dal compilatore, e il set non memorizza alcun contatore.
+	Una politica di strumentazione deve fornire i metodi on_add, on_remove,
+	on_lookup, on_duplicate, on_allocation, snapshot e reset, e il tipo timer,
+	costruito all'inizio di un'operazione e distrutto alla sua fine.
+**/
+struct no_stats{
+	static const bool enabled = false;	///< false: il set non chiama i metodi che richiedono lavoro aggiuntivo
+
+	/**
+		@brief Cronometro di un'operazione, vuoto
+	**/
+	struct timer{
+		explicit timer(no_stats) {}
+	};
+
+	void on_add(void) {}
+	void on_remove(unsigned long long) {}
+	void on_lookup(unsigned long long) {}
+	void on_duplicate(void) {}
+	void on_allocation(void) {}
+	set_stats snapshot(void) const { return set_stats(); }
+	void reset(void) {}
+};
+
+/**
+	@brief Politica di strumentazione con contatori
+
+	Conta aggiunte, rimozioni, ricerche (con il numero di elementi confrontati),
+	duplicati rifiutati e allocazioni. Le latenze non vengono misurate.
+	I contatori sono aggiornati anche dalle ricerche, che quindi non vanno
+	eseguite in concorrenza da più thread sullo stesso set.
+**/
+class counting_stats{
+protected:
+	set_stats _stats;	///< Contatori
+
+public:
+	static const bool enabled = true;	///< true: il set aggiorna i contatori
+
+	/**
+		@brief Cronometro di un'operazione, vuoto
+	**/
+	struct timer{
+		explicit timer(counting_stats &) {}
+	};
+
+	void on_add(void){
+		_stats.adds++;
+	}
+
+	void on_remove(unsigned long long n){
+		_stats.removes += n;
+	}
+
+	void on_lookup(unsigned long long visited){
+		_stats.lookups++;
+		_stats.visited += visited;
+		if(visited > _stats.max_visited)
+			_stats.max_visited = visited;
+	}
+
+	void on_duplicate(void){
+		_stats.duplicates++;
+	}
+
+	void on_allocation(void){
+		_stats.allocations++;
+	}
+
+	set_stats snapshot(void) const{
+		return _stats;
+	}
+
+	void reset(void){
+		_stats = set_stats();
+	}
+};
+
+/**
+	@brief Politica di strumentazione con contatori e latenze campionate
+
+	Come counting_stats, ma cronometra un'operazione (aggiunta, rimozione o
+	ricerca pubblica) ogni Rate e ne registra la durata nell'istogramma.
+	@param Rate Intervallo di campionamento, in operazioni.
+**/
+template <unsigned int Rate = 64>
+class sampled_stats : public counting_stats{
+	unsigned int _tick;	///< Operazioni dall'ultimo campione
+
+public:
+	/**
+		@brief Cronometro di un'operazione
+
+		Registra la durata dell'operazione solo se è quella campionata.
+	**/
+	class timer{
+		sampled_stats *_owner;	///< Politica da aggiornare, 0 se l'operazione non è campionata
+		std::chrono::steady_clock::time_point _start;	///< Inizio dell'operazione
+
+	public:
+		explicit timer(sampled_stats &owner) : _owner(0) {
+			if(++owner._tick >= Rate){
+				owner._tick = 0;
+				_owner = &owner;
+				_start = std::chrono::steady_clock::now();
+			}
+		}
+
+		timer(const timer &other) = delete;
+		timer &operator=(const timer &other) = delete;
+
+		~timer(){
+			if(_owner == 0)
+				return;
+
+			unsigned long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - _start).count();
+			unsigned int bucket = 0;
+			while(ns > 1 && bucket + 1 < set_stats::buckets){
+				ns >>= 1;
+				bucket++;
+			}
+			_owner->_stats.samples++;
+			_owner->_stats.latency[bucket]++;
+		}
+	};
+
+	sampled_stats() : _tick(0) {}
+};
+
+#endif
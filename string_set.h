@@ -0,0 +1,593 @@
+#ifndef STRING_SET_H
+#define STRING_SET_H
+
+#include "set.h"	//hash_index, already_existing_exception, not_existing_exception
+#include <string_view>	//string_view
+#include <functional>	//hash
+#include <vector>	//vector
+#include <cstring>	//memcmp, memcpy
+#include <cstdint>	//uint32_t
+#include <stdexcept>	//length_error
+#include <iterator>	//forward_iterator_tag
+#include <ostream>	//ostream
+#include <atomic>	//atomic
+#include <thread>	//this_thread::yield
+#include <algorithm>	//lower_bound
+
+/**
+	@file string_set.h
+	@brief Dichiarazione della classe string_set
+**/
+
+/**
+	@brief Set di stringhe memorizzate in un'area contigua
+
+	Classe che rappresenta un set di stringhe specializzato per molte stringhe corte
+	(es. identificatori). I caratteri di tutte le stringhe sono memorizzati uno dopo
+	l'altro in un unico array (l'arena), e per ogni stringa il set mantiene posizione,
+	lunghezza e hash, calcolato una sola volta all'inserimento. La ricerca usa un indice
+	hash ad indirizzamento aperto e confronta i caratteri solo se hash e lunghezza
+	coincidono. Tutti i metodi accettano std::string_view, quindi aggiungere o cercare
+	una stringa non richiede di costruire una std::string temporanea.
+	Come set, l'iterazione avviene in ordine di inserimento.
+	La rimozione lascia una lapide; quando le lapidi superano la metà degli elementi
+	l'arena viene compattata, preservando l'ordine.
+	Le string_view restituite dal set restano valide fino alla successiva aggiunta
+	o rimozione. Il set può contenere al più 2^32 - 1 stringhe, ognuna lunga meno di 4GB.
+**/
+class string_set{
+
+public:
+	typedef std::size_t size_type;	///< Definzione del tipo corrispondente a size
+
+private:
+	typedef std::uint32_t handle;	///< Posizione di una stringa in _entries
+
+	static const std::uint32_t dead = 0xffffffffu;	///< Lunghezza che marca una lapide
+
+	/**
+		@brief Stato della tabella delle posizioni
+	**/
+	enum positions_state : unsigned char{
+		positions_stale,	///< La tabella va ricostruita
+		positions_building,	///< Un thread sta costruendo la tabella in operator[]
+		positions_ready	///< La tabella riflette il contenuto del set
+	};
+
+	/**
+		@brief Descrittore di una stringa
+
+		Posizione e lunghezza dei caratteri nell'arena e hash della stringa.
+	**/
+	struct entry{
+		std::size_t hash;	///< Hash della stringa
+		std::size_t offset;	///< Posizione del primo carattere nell'arena
+		std::uint32_t length;	///< Numero di caratteri, dead se la stringa è stata rimossa
+	};
+
+	std::vector<char> _arena;	///< Caratteri delle stringhe, uno dopo l'altro
+	std::vector<entry> _entries;	///< Descrittori, in ordine di inserimento
+	set_detail::hash_index<handle> _index;	///< Indice hash dei descrittori
+	size_type _holes;	///< Numero di lapidi in _entries
+	size_type _dead_bytes;	///< Caratteri delle stringhe rimosse ancora nell'arena
+	mutable std::vector<handle> _positions;	///< Tabella delle posizioni usata da operator[] in presenza di lapidi
+	mutable std::atomic<positions_state> _positions_state;	///< Stato di _positions rispetto al contenuto del set
+
+	/**
+		@brief Hash di una stringa
+
+		@param s Stringa di cui calcolare l'hash.
+		@return L'hash della stringa.
+	**/
+	static std::size_t hash_value(std::string_view s){
+		return std::hash<std::string_view>()(s);
+	}
+
+	/**
+		@brief Caratteri di una stringa
+
+		@param e Descrittore della stringa.
+		@return La stringa come string_view sull'arena.
+	**/
+	std::string_view view(const entry &e) const{
+		return std::string_view(_arena.data() + e.offset, e.length);
+	}
+
+	/**
+		@brief Ricerca di una stringa
+
+		@param s Stringa da cercare.
+		@param h Hash della stringa.
+		@return La posizione del descrittore, oppure dead se la stringa non è presente.
+	**/
+	handle search(std::string_view s, std::size_t h) const{
+		return _index.find(h, [&](handle n){
+			const entry &e = _entries[n];
+			return e.length == s.size() && std::memcmp(_arena.data() + e.offset, s.data(), s.size()) == 0;
+		});
+	}
+
+	/**
+		@brief Compatta l'arena e i descrittori
+
+		Elimina le lapidi e i caratteri delle stringhe rimosse mantenendo l'ordine,
+		quindi ricostruisce l'indice con gli hash già calcolati.
+	**/
+	void compact(void){
+
+		std::vector<char> arena;
+		arena.reserve(_arena.size() - _dead_bytes);
+		std::size_t w = 0;
+
+		for(std::size_t r = 0; r < _entries.size(); ++r){
+			entry e = _entries[r];
+			if(e.length == dead)
+				continue;
+			arena.insert(arena.end(), _arena.data() + e.offset, _arena.data() + e.offset + e.length);
+			e.offset = arena.size() - e.length;
+			_entries[w++] = e;
+		}
+		_entries.resize(w);
+		_arena.swap(arena);
+		_holes = 0;
+		_dead_bytes = 0;
+
+		_index.reset();
+		_index.reserve(_entries.size());
+		for(std::size_t k = 0; k < _entries.size(); ++k)
+			_index.insert(_entries[k].hash, static_cast<handle>(k));
+	}
+
+	/**
+		@brief Aggiunge una stringa non presente
+
+		@param s Stringa da aggiungere.
+		@param h Hash della stringa.
+		@throw std::length_error Se la stringa è troppo lunga o il set è pieno.
+	**/
+	void append(std::string_view s, std::size_t h){
+
+		if(s.size() >= dead || _entries.size() >= dead)
+			throw std::length_error("string_set: too many or too long strings");
+
+		entry e;
+		e.hash = h;
+		e.offset = _arena.size();
+		e.length = static_cast<std::uint32_t>(s.size());
+
+		_index.reserve(_index.size() + 1);
+		_entries.push_back(e);
+		try{
+			_arena.insert(_arena.end(), s.begin(), s.end());
+		}catch(...){
+			_entries.pop_back();
+			throw;
+		}
+		_index.insert(h, static_cast<handle>(_entries.size() - 1));
+
+		if(_positions_state == positions_ready){
+			try{
+				_positions.push_back(static_cast<handle>(_entries.size() - 1));
+			}catch(...){
+				_positions.clear();
+				_positions_state = positions_stale;
+			}
+		}
+	}
+
+public:
+	/**
+		@brief Costruttore di default
+
+		Costruttore di default per istanziare un set vuoto.
+	**/
+	string_set() : _index(dead), _holes(0), _dead_bytes(0), _positions_state(positions_stale) {}
+
+	/**
+		@brief Costruttore secondario (COSTRUTTORE DI COPIA)
+
+		Costruttore secondario. Permette di creare un set come copia di un altro set;
+		la tabella delle posizioni verrà costruita al primo accesso.
+		@param other Set sorgente.
+	**/
+	string_set(const string_set &other) : _arena(other._arena), _entries(other._entries),
+		_index(other._index), _holes(other._holes), _dead_bytes(other._dead_bytes),
+		_positions_state(positions_stale) {}
+
+	/**
+		@brief Costruttore secondario (COSTRUTTORE DI SPOSTAMENTO)
+
+		Costruttore secondario. Permette di creare un set acquisendo le stringhe
+		di un altro set senza copiarle; il set sorgente rimane vuoto.
+		@param other Set sorgente.
+	**/
+	string_set(string_set &&other) noexcept : _index(dead), _holes(0), _dead_bytes(0),
+		_positions_state(positions_stale) {
+		swap(other);
+	}
+
+	/**
+		@brief Operatore di assegnamento
+
+		Operatore di assegnamento. Permette la copia tra set.
+		@param other Set sorgente.
+		@return Riferimento a this.
+	**/
+	string_set &operator=(const string_set &other){
+
+		if(this != &other){
+			string_set tmp(other);
+			swap(tmp);
+		}
+		return *this;
+	}
+
+	/**
+		@brief Operatore di assegnamento per spostamento
+
+		Operatore di assegnamento. Libera le stringhe di this e acquisisce
+		quelle di other senza copiarle; il set sorgente rimane vuoto.
+		@param other Set sorgente.
+		@return Riferimento a this.
+	**/
+	string_set &operator=(string_set &&other) noexcept{
+
+		if(this != &other){
+			clear_set();
+			swap(other);
+		}
+		return *this;
+	}
+
+	/**
+		@brief Costruttore secondario (COSTRUTTORE GENERICO)
+
+		Costruttore secondario. Permette di creare un set a partire da una sequenza
+		di stringhe definita da una coppia generica di iteratori.
+		@param b Iteratore all'inizio della sequenza di dati.
+		@param e Iteratore alla fine della sequenza di dati.
+		@throw already_existing_exception Eccezione che viene lanciata
+		in caso di stringhe duplicate.
+	**/
+	template <typename Q>
+	string_set(Q b, Q e) : _index(dead), _holes(0), _dead_bytes(0), _positions_state(positions_stale) {
+		for(; b != e; ++b)
+			add(*b);
+	}
+
+	/**
+		@brief Predispone il set per n stringhe con chars caratteri complessivi
+
+		@param n Numero di stringhe.
+		@param chars Numero complessivo di caratteri.
+	**/
+	void reserve(size_type n, size_type chars){
+		_entries.reserve(n);
+		_arena.reserve(chars);
+		_index.reserve(n);
+	}
+
+	/**
+		@brief Aggiunge una stringa al set
+
+		@param s La stringa da aggiungere al set.
+		@throw already_existing_exception Eccezione che viene lanciata
+		in caso di stringa già esistente nel set.
+	**/
+	void add(std::string_view s){
+		if(!try_add(s))
+			throw already_existing_exception();
+	}
+
+	/**
+		@brief Aggiunge una stringa al set, se non esistente
+
+		@param s La stringa da aggiungere al set.
+		@return true se la stringa è stata aggiunta, false se era già esistente.
+	**/
+	bool try_add(std::string_view s){
+
+		std::size_t h = hash_value(s);
+		if(search(s, h) != dead)
+			return false;
+		append(s, h);
+		return true;
+	}
+
+	/**
+		@brief Rimuove una stringa dal set
+
+		@param s La stringa da rimuovere dal set.
+		@throw not_existing_exception Eccezione che viene lanciata
+		in caso di stringa non esistente nel set.
+	**/
+	void remove(std::string_view s){
+		if(!try_remove(s))
+			throw not_existing_exception();
+	}
+
+	/**
+		@brief Rimuove una stringa dal set, se esistente
+
+		@param s La stringa da rimuovere dal set.
+		@return true se la stringa è stata rimossa, false se non era presente.
+	**/
+	bool try_remove(std::string_view s){
+
+		std::size_t h = hash_value(s);
+		handle n = search(s, h);
+		if(n == dead)
+			return false;
+
+		_index.erase(h, n);
+		_dead_bytes += _entries[n].length;
+		_entries[n].length = dead;
+		_holes++;
+		if(_positions_state == positions_ready)
+			//gli indici dei descrittori crescono con la posizione
+			_positions.erase(std::lower_bound(_positions.begin(), _positions.end(), n));
+
+		//le lapidi in coda vengono scartate insieme ai loro caratteri,
+		//che si trovano tutti dopo l'ultima stringa presente
+		while(!_entries.empty() && _entries.back().length == dead){
+			_entries.pop_back();
+			_holes--;
+		}
+		std::size_t end = _entries.empty() ? 0 : _entries.back().offset + _entries.back().length;
+		_dead_bytes -= _arena.size() - end;
+		_arena.resize(end);
+
+		if(_holes * 2 > _entries.size()){
+			compact();
+			_positions.clear();
+			_positions_state = positions_stale;
+		}
+		return true;
+	}
+
+	/**
+		@brief Verifica la presenza di una stringa
+
+		@param s La stringa da cercare.
+		@return true se la stringa è presente nel set.
+	**/
+	bool contains(std::string_view s) const{
+		return search(s, hash_value(s)) != dead;
+	}
+
+	/**
+		@brief Numero di occorrenze di una stringa
+
+		@param s La stringa da cercare.
+		@return 1 se la stringa è presente nel set, 0 altrimenti.
+	**/
+	size_type count(std::string_view s) const{
+		return contains(s) ? 1 : 0;
+	}
+
+	/**
+		@brief Accesso ai dati in sola lettura
+
+		Metodo per leggere l'index-esima stringa del set, nell'ordine di inserimento.
+		In presenza di lapidi l'accesso usa una tabella delle posizioni costruita
+		al primo accesso e aggiornata da add e remove, come in set; più thread
+		possono leggere in concorrenza lo stesso set, purché nessuno lo modifichi.
+		@pre E' necessario che index < size.
+		@param index Indice della stringa nel set da leggere.
+		@return La stringa in posizione index-esima.
+	**/
+	std::string_view operator[](size_type index) const{
+
+		assert(index < size());
+
+		if(_holes == 0)
+			return view(_entries[index]);
+
+		while(_positions_state.load(std::memory_order_acquire) != positions_ready){
+			positions_state expected = positions_stale;
+			if(!_positions_state.compare_exchange_strong(expected, positions_building,
+				std::memory_order_acquire)){
+				//un altro thread sta costruendo la tabella
+				std::this_thread::yield();
+				continue;
+			}
+			try{
+				_positions.clear();
+				_positions.reserve(size());
+				for(std::size_t k = 0; k < _entries.size(); ++k)
+					if(_entries[k].length != dead)
+						_positions.push_back(static_cast<handle>(k));
+			}catch(...){
+				_positions_state.store(positions_stale, std::memory_order_release);
+				throw;
+			}
+			_positions_state.store(positions_ready, std::memory_order_release);
+		}
+		return view(_entries[_positions[index]]);
+	}
+
+	/**
+		@brief Dimensione del set
+
+		@return Il numero di stringhe contenute nel set.
+	**/
+	size_type size(void) const{
+		return _entries.size() - _holes;
+	}
+
+	/**
+		@brief Numero di caratteri nell'arena
+
+		@return I caratteri memorizzati, comprese le stringhe rimosse non ancora compattate.
+	**/
+	size_type arena_size(void) const{
+		return _arena.size();
+	}
+
+	/**
+		@brief Svuota il set
+
+		Metodo che elimina tutte le stringhe del set liberando la memoria.
+	**/
+	void clear_set(void){
+		std::vector<char>().swap(_arena);
+		std::vector<entry>().swap(_entries);
+		std::vector<handle>().swap(_positions);
+		_index.clear();
+		_holes = 0;
+		_dead_bytes = 0;
+		_positions_state = positions_stale;
+	}
+
+	/**
+		@brief Scambia il contenuto di due set
+
+		@param other Set con cui scambiare il contenuto.
+	**/
+	void swap(string_set &other) noexcept{
+		_arena.swap(other._arena);
+		_entries.swap(other._entries);
+		_index.swap(other._index);
+		std::swap(_holes, other._holes);
+		std::swap(_dead_bytes, other._dead_bytes);
+		_positions.swap(other._positions);
+		positions_state state = _positions_state;
+		_positions_state = other._positions_state.load();
+		other._positions_state = state;
+	}
+
+	/**
+		@brief Definizione della classe const_iterator
+
+		Classe che implementa iteratori di tipo costante utilizzabili nella classe
+		string_set. Il dereferenziamento restituisce una string_view sull'arena.
+	**/
+	class const_iterator {
+		const string_set *s;
+		std::size_t k;
+
+		void skip(void){
+			while(k < s->_entries.size() && s->_entries[k].length == dead)
+				++k;
+		}
+
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef std::string_view          value_type;
+		typedef ptrdiff_t                 difference_type;
+		typedef const std::string_view*   pointer;
+		typedef std::string_view          reference;
+
+		/**
+			@brief Costruttore di default
+
+			Costruttore di default per istanziare un const_iterator.
+		**/
+		const_iterator() : s(0), k(0){}
+
+		/**
+			@brief Operatore di dereferenziamento
+
+			Operatore di dereferenziamento. Ritorna il dato riferito dall'iteratore.
+			@return La stringa riferita dall'iteratore.
+		**/
+		reference operator*() const {
+			return s->view(s->_entries[k]);
+		}
+
+		/**
+			@brief Operatore di iterazione post-incremento
+
+			Operatore di iterazione post-incremento. Incrementa il const_iteratore
+			ma ne ritorna la copia non iterata.
+			@return La copia del const_iterator.
+		**/
+		const_iterator operator++(int) {
+			const_iterator tmp(*this);
+			++k;
+			skip();
+			return tmp;
+		}
+
+		/**
+			@brief Operatore di iterazione pre-incremento
+
+			Operatore di iterazione pre-incremento. Incrementa il const_iteratore
+			ma ne ritorna il riferimento
+			@return Il riferimento al const_iterator.
+		**/
+		const_iterator& operator++() {
+			++k;
+			skip();
+			return *this;
+		}
+
+		/**
+			@brief Operatore di uguaglianza
+
+			Operatore di uguaglianza. Esegue una comparazione tra due const_iterator,
+			se sono uguali restituisce true, altrimenti restituisce false.
+			@param other Il const_iterator con cui effettuare la comparazione.
+			@return Il risultato della comparazione di due const_iterator.
+		**/
+		bool operator==(const const_iterator &other) const {
+			return (k==other.k);
+		}
+
+		/**
+			@brief Operatore di diversità
+
+			Operatore di diversità. Esegue una comparazione tra due const_iterator,
+			se sono diversi restituisce true, altrimenti restituisce false.
+			@param other Il const_iterator con cui effettuare la comparazione.
+			@return Il risultato della comparazione di due const_iterator.
+		**/
+		bool operator!=(const const_iterator &other) const {
+			return (k!=other.k);
+		}
+
+	private:
+
+		friend class string_set;
+		const_iterator(const string_set *ss, std::size_t kk) : s(ss), k(kk){
+			skip();
+		}
+	}; // classe const_iterator
+
+	/**
+		@brief Iteratore all'inizio della sequenza di dati
+
+		@return L'iteratore all'inizio della sequenza di dati.
+	**/
+	const_iterator begin() const {
+		return const_iterator(this, 0);
+	}
+
+	/**
+		@brief Iteratore alla fine della sequenza di dati
+
+		@return L'iteratore alla fine della sequenza di dati.
+	**/
+	const_iterator end() const {
+		return const_iterator(this, _entries.size());
+	}
+};
+
+/**
+	@brief Operatore di stream
+
+	Permette di spedire su uno stream di output il contenuto dello string_set.
+	@param os stream di output
+	@param data_set Set sorgente i cui elementi verranno spediti sullo stream.
+	@return Il riferimento allo stream di output.
+**/
+inline std::ostream &operator<<(std::ostream &os, const string_set &data_set){
+
+	string_set::const_iterator i, ie;
+
+	for(i=data_set.begin(), ie=data_set.end(); i!=ie; ++i)
+		os << *i << " ";
+	return os;
+}
+
+#endif